@@ -48,6 +48,13 @@ public:
     virtual const block_index_space<N> &get_bis() const;
     //@}
 
+    /** \brief Sets the name under which the memory of the tensor is
+            accounted for (see memory_accounting)
+     **/
+    void set_name(const std::string &name) {
+        m_bt.set_name(name);
+    }
+
 protected:
     //!    \name Implementation of libtensor::block_tensor_i<N, T>
     //@{
@@ -9,11 +9,13 @@
 #include "btod_copy.h"
 #include "btod_diag.h"
 #include "btod_dirsum.h"
+#include "btod_div_dirsum.h"
 #include "btod_dotprod.h"
 #include "btod_ewmult2.h"
 #include "btod_export.h"
 #include "btod_extract.h"
 #include "btod_mult.h"
+#include "btod_mult_direct.h"
 #include "btod_mult1.h"
 #include "btod_random.h"
 #include "btod_scale.h"
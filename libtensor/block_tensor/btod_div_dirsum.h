@@ -0,0 +1,118 @@
+#ifndef LIBTENSOR_BTOD_DIV_DIRSUM_H
+#define LIBTENSOR_BTOD_DIV_DIRSUM_H
+
+#include <libtensor/block_tensor/btod_traits.h>
+#include <libtensor/core/scalar_transf_double.h>
+#include <libtensor/gen_block_tensor/additive_gen_bto.h>
+#include <libtensor/gen_block_tensor/gen_bto_div_dirsum.h>
+
+namespace libtensor {
+
+
+/** \brief Divides the result of a block tensor operation by the direct sum
+        of two block tensors
+    \tparam N Order of the first term of the direct sum.
+    \tparam M Order of the second term of the direct sum.
+
+    Computes
+    \f$ c_{ij\cdots mn\cdots} = n_{ij\cdots mn\cdots} /
+        (k_a a_{ij\cdots} + k_b b_{mn\cdots}) \f$
+    without storing the numerator or the direct sum (see gen_bto_div_dirsum).
+
+    \ingroup libtensor_block_tensor_btod
+ **/
+template<size_t N, size_t M>
+class btod_div_dirsum :
+    public additive_gen_bto<N + M, btod_traits::bti_traits>,
+    public noncopyable {
+
+public:
+    static const char k_clazz[]; //!< Class name
+
+public:
+    typedef typename btod_traits::bti_traits bti_traits;
+
+private:
+    gen_bto_div_dirsum<N, M, btod_traits, btod_div_dirsum<N, M> > m_gbto;
+
+public:
+    //! \name Constructors / destructor
+    //@{
+
+    /** \brief Initializes the operation
+        \param opn Numerator
+        \param bta First term of the denominator (A)
+        \param ka Scalar transformation of A
+        \param btb Second term of the denominator (B)
+        \param kb Scalar transformation of B
+        \param perms Permutation of the direct sum
+        \param trc Scalar transformation of the result
+     **/
+    btod_div_dirsum(
+            additive_gen_bto<N + M, bti_traits> &opn,
+            block_tensor_rd_i<N, double> &bta, const scalar_transf<double> &ka,
+            block_tensor_rd_i<M, double> &btb, const scalar_transf<double> &kb,
+            const permutation<N + M> &perms = permutation<N + M>(),
+            const scalar_transf<double> &trc = scalar_transf<double>()) :
+
+        m_gbto(opn, bta, ka, btb, kb, perms, trc) {
+
+    }
+
+    /** \brief Virtual destructor
+     **/
+    virtual ~btod_div_dirsum() { }
+
+    //@}
+
+    //! \name Implementation of libtensor::direct_gen_bto<N + M, bti_traits>
+    //@{
+
+    virtual const block_index_space<N + M> &get_bis() const {
+        return m_gbto.get_bis();
+    }
+
+    virtual const symmetry<N + M, double> &get_symmetry() const {
+        return m_gbto.get_symmetry();
+    }
+
+    virtual const assignment_schedule<N + M, double> &get_schedule() const {
+        return m_gbto.get_schedule();
+    }
+
+    virtual void perform(gen_block_stream_i<N + M, bti_traits> &out) {
+        m_gbto.perform(out);
+    }
+
+    //@}
+
+    //! \name Implementation of libtensor::additive_gen_bto<N + M, bti_traits>
+    //@{
+
+    virtual void perform(gen_block_tensor_i<N + M, bti_traits> &btc);
+
+    virtual void perform(gen_block_tensor_i<N + M, bti_traits> &btc,
+            const scalar_transf<double> &d);
+
+    virtual void compute_block(
+            bool zero,
+            const index<N + M> &ic,
+            const tensor_transf<N + M, double> &trc,
+            dense_tensor_wr_i<N + M, double> &blkc);
+
+    virtual void compute_block(
+            const index<N + M> &ic,
+            dense_tensor_wr_i<N + M, double> &blkc) {
+
+        compute_block(true, ic, tensor_transf<N + M, double>(), blkc);
+    }
+
+    //@}
+
+    void perform(block_tensor_i<N + M, double> &btc, double d);
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_BTOD_DIV_DIRSUM_H
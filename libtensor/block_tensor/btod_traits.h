@@ -72,6 +72,11 @@ struct btod_traits {
         typedef tod_dirsum<N, M> type;
     };
 
+    template<size_t N, size_t M>
+    struct to_div_dirsum_type {
+        typedef tod_div_dirsum<N, M> type;
+    };
+
     template<size_t N>
     struct to_dotprod_type {
         typedef tod_dotprod<N> type;
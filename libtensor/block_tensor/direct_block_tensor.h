@@ -39,7 +39,14 @@ public:
     //!    \name Construction and destruction
     //@{
 
-    direct_block_tensor(operation_t &op) : m_gbt(op), m_ctrl(m_gbt) { }
+    /** \brief Initializes the direct block tensor
+        \param op Underlying operation.
+        \param cache_limit Max size of cached blocks in bytes (0 - no cache).
+        \param cost_aware Account for the compute time in eviction decisions.
+     **/
+    direct_block_tensor(operation_t &op, size_t cache_limit = 0,
+        bool cost_aware = false) :
+        m_gbt(op, cache_limit, cost_aware), m_ctrl(m_gbt) { }
 
     virtual ~direct_block_tensor() { }
     //@}
@@ -48,6 +55,31 @@ public:
         return m_gbt.get_bis();
     }
 
+    //!    \name Block cache
+    //@{
+
+    void set_cache_limit(size_t cache_limit) {
+        m_gbt.set_cache_limit(cache_limit);
+    }
+
+    size_t get_cache_limit() const {
+        return m_gbt.get_cache_limit();
+    }
+
+    void clear_cache() {
+        m_gbt.clear_cache();
+    }
+
+    direct_gen_block_cache_stats get_cache_stats() {
+        return m_gbt.get_cache_stats();
+    }
+
+    void reset_cache_stats() {
+        m_gbt.reset_cache_stats();
+    }
+
+    //@}
+
 protected:
     //!    \name Implementation of libtensor::block_tensor_rd_i<N, T>
     //@{
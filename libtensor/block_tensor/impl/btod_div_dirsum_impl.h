@@ -0,0 +1,68 @@
+#ifndef LIBTENSOR_BTOD_DIV_DIRSUM_IMPL_H
+#define LIBTENSOR_BTOD_DIV_DIRSUM_IMPL_H
+
+#include <libtensor/gen_block_tensor/gen_bto_aux_add.h>
+#include <libtensor/gen_block_tensor/gen_bto_aux_copy.h>
+#include "../btod_div_dirsum.h"
+
+namespace libtensor {
+
+
+template<size_t N, size_t M>
+const char btod_div_dirsum<N, M>::k_clazz[] = "btod_div_dirsum<N, M>";
+
+
+template<size_t N, size_t M>
+void btod_div_dirsum<N, M>::perform(
+        gen_block_tensor_i<N + M, bti_traits> &btc) {
+
+    gen_bto_aux_copy<N + M, btod_traits> out(get_symmetry(), btc);
+    out.open();
+    perform(out);
+    out.close();
+}
+
+
+template<size_t N, size_t M>
+void btod_div_dirsum<N, M>::perform(
+        gen_block_tensor_i<N + M, bti_traits> &btc,
+        const scalar_transf<double> &d) {
+
+    typedef block_tensor_i_traits<double> bti_traits;
+
+    gen_block_tensor_rd_ctrl<N + M, bti_traits> cc(btc);
+    std::vector<size_t> nzblkc;
+    cc.req_nonzero_blocks(nzblkc);
+    addition_schedule<N + M, btod_traits> asch(get_symmetry(),
+            cc.req_const_symmetry());
+    asch.build(get_schedule(), nzblkc);
+
+    gen_bto_aux_add<N + M, btod_traits> out(get_symmetry(), asch, btc, d);
+    out.open();
+    perform(out);
+    out.close();
+}
+
+
+template<size_t N, size_t M>
+void btod_div_dirsum<N, M>::perform(block_tensor_i<N + M, double> &btc,
+        double d) {
+
+    perform(btc, scalar_transf<double>(d));
+}
+
+
+template<size_t N, size_t M>
+void btod_div_dirsum<N, M>::compute_block(
+        bool zero,
+        const index<N + M> &ic,
+        const tensor_transf<N + M, double> &trc,
+        dense_tensor_wr_i<N + M, double> &blkc) {
+
+    m_gbto.compute_block(zero, ic, trc, blkc);
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_BTOD_DIV_DIRSUM_IMPL_H
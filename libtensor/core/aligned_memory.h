@@ -0,0 +1,145 @@
+#ifndef LIBTENSOR_ALIGNED_MEMORY_H
+#define LIBTENSOR_ALIGNED_MEMORY_H
+
+#include <cstdlib> // for size_t
+#include <iostream>
+#include <libutil/singleton.h>
+
+namespace libtensor {
+
+
+/** \brief Raw memory for tensor blocks with alignment and huge pages
+
+    Every block returned by allocate() starts at a multiple of the alignment
+    (64 bytes by default, a cache line and the width of AVX-512 vectors),
+    so vectorized kernels can use aligned loads and stores.
+
+    Blocks of at least get_huge_min() bytes are mapped directly from
+    the system and backed by huge pages to reduce TLB misses:
+     - HUGE_TRANSPARENT (default) asks the kernel to use transparent huge
+       pages for the mapping (madvise(MADV_HUGEPAGE));
+     - HUGE_EXPLICIT takes pages from the pool of explicitly reserved huge
+       pages (MAP_HUGETLB) and falls back to transparent huge pages if
+       the pool is exhausted or unavailable;
+     - HUGE_NONE allocates all blocks from the heap.
+    On systems without these features, large blocks are mapped with
+    regular pages.
+
+    The statistics report how much memory is in use, at most, and how much
+    of it was placed on huge pages. get_pressure() compares the memory in use
+    with the memory limit of the allocator (see allocator::init()).
+
+    \ingroup libtensor_core
+ **/
+class aligned_memory : public libutil::singleton<aligned_memory> {
+    friend class libutil::singleton<aligned_memory>;
+
+public:
+    enum {
+        HUGE_NONE, //!< No huge pages
+        HUGE_TRANSPARENT, //!< Transparent huge pages
+        HUGE_EXPLICIT //!< Explicit huge pages, then transparent ones
+    };
+
+    /** \brief Memory usage statistics (in bytes)
+     **/
+    struct stats {
+        size_t nbytes; //!< Currently allocated
+        size_t nbytes_peak; //!< Peak allocated
+        size_t nbytes_hugetlb; //!< On explicit huge pages
+        size_t nbytes_thp; //!< In mappings advised to use transparent pages
+        size_t nbytes_thp_resident; //!< Actually on transparent huge pages
+            //!< (whole process, 0 if unknown)
+    };
+
+private:
+    size_t m_align; //!< Alignment of blocks
+    int m_huge_mode; //!< Use of huge pages
+    size_t m_huge_min; //!< Smallest block backed by huge pages
+    volatile size_t m_nbytes; //!< Allocated bytes
+    volatile size_t m_nbytes_peak; //!< Peak allocated bytes
+    volatile size_t m_nbytes_hugetlb; //!< Bytes on explicit huge pages
+    volatile size_t m_nbytes_thp; //!< Bytes advised as transparent pages
+    size_t m_limit; //!< Memory limit (0 if unknown)
+
+protected:
+    aligned_memory();
+
+public:
+    /** \brief Changes the settings (must be called before any memory is
+            allocated)
+        \param align Alignment of blocks (power of two up to 4096 bytes).
+        \param huge_mode Use of huge pages (HUGE_NONE, HUGE_TRANSPARENT,
+            or HUGE_EXPLICIT).
+        \param huge_min Smallest block to be backed by huge pages in bytes.
+     **/
+    static void configure(size_t align, int huge_mode, size_t huge_min);
+
+    /** \brief Returns the alignment of blocks in bytes
+     **/
+    static size_t get_alignment() {
+        return get_instance().m_align;
+    }
+
+    /** \brief Returns the smallest block backed by huge pages in bytes
+     **/
+    static size_t get_huge_min() {
+        return get_instance().m_huge_min;
+    }
+
+    /** \brief Allocates an aligned block of memory
+        \param sz Size in bytes.
+        \return Pointer to the block.
+        \throw std::bad_alloc If there is not enough memory.
+     **/
+    static void *allocate(size_t sz);
+
+    /** \brief Frees a block previously allocated by allocate()
+        \param p Pointer to the block (may be null).
+     **/
+    static void deallocate(void *p) throw();
+
+    /** \brief Returns memory usage statistics
+     **/
+    static stats get_stats();
+
+    /** \brief Returns the number of bytes in use
+     **/
+    static size_t get_nbytes() {
+        return get_instance().m_nbytes;
+    }
+
+    /** \brief Sets the memory limit used to compute the memory pressure
+        \param limit Memory limit in bytes (0 if unknown).
+     **/
+    static void set_limit(size_t limit) {
+        get_instance().m_limit = limit;
+    }
+
+    /** \brief Returns the memory limit in bytes (0 if unknown)
+     **/
+    static size_t get_limit() {
+        return get_instance().m_limit;
+    }
+
+    /** \brief Returns the fraction of the memory limit in use (0 if
+            the limit is unknown, may exceed 1)
+     **/
+    static double get_pressure() {
+        const aligned_memory &am = get_instance();
+        return am.m_limit > 0 ? double(am.m_nbytes) / double(am.m_limit) : 0.0;
+    }
+
+    /** \brief Prints memory usage statistics
+     **/
+    static void print_stats(std::ostream &os);
+
+private:
+    void add_bytes(size_t sz);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_ALIGNED_MEMORY_H
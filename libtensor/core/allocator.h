@@ -2,6 +2,9 @@
 #define LIBTENSOR_ALLOCATOR_H
 
 #include <cstdlib> // for size_t
+#include <cstring> // for memcpy
+#include "aligned_memory.h"
+#include "memory_accounting.h"
 
 namespace libtensor {
 
@@ -53,6 +56,11 @@ public:
 public:
     static const pointer_type invalid_pointer; //!< Invalid pointer constant
 
+private:
+    //  Keys of the memory accounting are made from pointers
+    typedef char key_size_check[
+        sizeof(pointer_type) <= sizeof(const void*) ? 1 : -1];
+
 private:
     static allocator_wrapper_i<T> *m_aimpl; //!< Implementation
     static size_t m_base_sz; //!< Exponential base of data block size
@@ -105,7 +113,12 @@ public:
         \return Virtual memory pointer.
      **/
     static pointer_type allocate(size_t sz) {
-        return m_aimpl->allocate(sz);
+        pointer_type p = m_aimpl->allocate(sz);
+        if(memory_accounting::is_enabled()) {
+            memory_accounting::on_allocate(get_key(p),
+                m_aimpl->get_block_size(sz));
+        }
+        return p;
     }
 
     /** \brief Deallocates (frees) a block of memory previously
@@ -113,6 +126,9 @@ public:
         \param p Virtual memory pointer.
      **/
     static void deallocate(const pointer_type &p) throw () {
+        if(memory_accounting::is_tracking()) {
+            memory_accounting::on_deallocate(get_key(p));
+        }
         m_aimpl->deallocate(p);
     }
 
@@ -156,6 +172,13 @@ public:
         m_aimpl->unlock_ro(p);
     }
 
+    /** \brief Returns the fraction of the memory limit in use
+            (see aligned_memory::get_pressure())
+     **/
+    static double get_pressure() {
+        return aligned_memory::get_pressure();
+    }
+
     /** \brief Sets a priority flag on a virtual memory block
         \param p Virtual memory pointer.
      **/
@@ -171,6 +194,12 @@ public:
     }
 
 private:
+    static const void *get_key(const pointer_type &p) {
+        const void *k = 0;
+        memcpy(&k, &p, sizeof(pointer_type));
+        return k;
+    }
+
     static pointer_type make_invalid_pointer();
     static allocator_wrapper_i<T> *make_default_allocator();
 
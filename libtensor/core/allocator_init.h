@@ -1,8 +1,10 @@
 #ifndef LIBTENSOR_ALLOCATOR_INIT_H
 #define LIBTENSOR_ALLOCATOR_INIT_H
 
+#include "aligned_memory.h"
 #include "allocator.h"
 #include "batching_policy_base.h"
+#include "impl/allocator_wrapper.h"
 
 namespace libtensor {
 
@@ -18,6 +20,7 @@ void allocator<T>::init(const AllocatorImpl &aimpl, size_t base_sz,
     m_base_sz = base_sz;
     m_min_sz = min_sz;
     m_max_sz = max_sz;
+    aligned_memory::set_limit(mem_limit * sizeof(T));
     batching_policy_base::set_batch_size(
         mem_limit / min_sz / base_sz / base_sz / base_sz / 2);
 }
@@ -28,6 +31,7 @@ void allocator<T>::shutdown() {
 
     m_aimpl->shutdown();
     m_aimpl = make_default_allocator();
+    aligned_memory::set_limit(0);
 }
 
 
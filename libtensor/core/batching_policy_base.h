@@ -9,6 +9,14 @@ namespace libtensor {
 
 /** \brief Base class to provide the batch size for batches of tensor blocks
 
+    The batch size is set by allocator::init() to use about half of
+    the memory limit. Operations that run many batches call scale() before
+    each batch to adapt the size to the memory in use at that point
+    (see aligned_memory::get_pressure()): with more than half of the limit
+    in use batches shrink, down to an eighth of the nominal size when
+    the limit is reached; with less in use batches grow, up to twice
+    the nominal size.
+
 	\sa gen_bto_contract2_batching_policy, gen_bto_contract3_batching_policy
 
 	\ingroup libtensor_core
@@ -18,6 +26,7 @@ class batching_policy_base : public libutil::singleton<batching_policy_base> {
 
 private:
     size_t m_batchsz; //!< Batch size
+    bool m_adaptive; //!< Whether batch sizes adapt to memory pressure
 
 protected:
     batching_policy_base();
@@ -25,6 +34,21 @@ protected:
 public:
     static void set_batch_size(size_t batchsz);
     static size_t get_batch_size();
+
+    /** \brief Enables or disables the adaptation of batch sizes to
+            memory pressure (enabled by default)
+     **/
+    static void set_adaptive(bool adaptive);
+
+    /** \brief Returns whether batch sizes adapt to memory pressure
+     **/
+    static bool is_adaptive();
+
+    /** \brief Adapts a batch size to the current memory pressure
+        \param bsz Nominal batch size.
+        \return Batch size to use now (at least 1).
+     **/
+    static size_t scale(size_t bsz);
 };
 
 
@@ -0,0 +1,72 @@
+#ifndef LIBTENSOR_BLOCK_CODEC_H
+#define LIBTENSOR_BLOCK_CODEC_H
+
+#include <cstdlib> // for size_t
+
+namespace libtensor {
+
+
+/** \brief Compression of tensor blocks
+
+    The lossless codec splits the data into byte planes (the first byte of
+    all elements, then the second byte, and so on) and compresses the result
+    with a fast LZ77 coder. Byte planes of floating-point numbers are much
+    more repetitive than the numbers themselves: sign and exponent bytes
+    rarely change, and zeros become long runs.
+
+    The lossy codec first rounds every number to the nearest multiple of
+    twice the error bound, which turns the data into small integers that
+    the lossless codec compresses well. The absolute error of each element
+    is at most the error bound (up to the rounding in the last bit). Blocks
+    with values too large for the bound are compressed losslessly.
+
+    The compressed size never exceeds get_max_size(). Incompressible data
+    are stored as they are.
+
+    \ingroup libtensor_core
+ **/
+class block_codec {
+public:
+    static const char k_clazz[]; //!< Class name
+
+public:
+    /** \brief Returns the largest possible size of compressed data
+        \param sz Size of the original data in bytes.
+     **/
+    static size_t get_max_size(size_t sz);
+
+    /** \brief Compresses data without loss
+        \param src Original data.
+        \param sz Size of the data in bytes.
+        \param elsz Size of the data elements in bytes.
+        \param dst Compressed data (at least get_max_size(sz) bytes).
+        \return Size of the compressed data.
+     **/
+    static size_t compress(const char *src, size_t sz, size_t elsz, char *dst);
+
+    /** \brief Compresses double-precision numbers with a bounded error
+        \param src Original data.
+        \param n Number of elements.
+        \param tol Largest absolute error (positive).
+        \param dst Compressed data (at least get_max_size(n * sizeof(double))
+            bytes).
+        \return Size of the compressed data.
+     **/
+    static size_t compress_lossy(const double *src, size_t n, double tol,
+        char *dst);
+
+    /** \brief Restores data compressed by compress() or compress_lossy()
+        \param src Compressed data.
+        \param zsz Size of the compressed data.
+        \param dst Restored data.
+        \param sz Size of the original data in bytes.
+        \throw generic_exception If the compressed data are corrupt.
+     **/
+    static void decompress(const char *src, size_t zsz, char *dst, size_t sz);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_BLOCK_CODEC_H
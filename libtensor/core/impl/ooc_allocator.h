@@ -0,0 +1,168 @@
+#ifndef LIBTENSOR_OOC_ALLOCATOR_H
+#define LIBTENSOR_OOC_ALLOCATOR_H
+
+#include "../ooc_memory.h"
+
+namespace libtensor {
+
+
+/** \brief Out-of-core allocator with a page file
+    \tparam T Data type.
+
+    Implements the allocator interface on top of ooc_memory: blocks are
+    kept in memory within mem_limit and moved to a page file in pfprefix
+    beyond it. Locked blocks are never evicted. prefetch() reads evicted
+    blocks in the background, and priority blocks (see tod_vmpriority) are
+    evicted last. With set_compression(), evicted blocks are compressed in
+    memory before they go to the page file.
+
+    Unlike vm_allocator, this implementation needs no external libraries.
+    It is selected by passing it to allocator::init().
+
+    \ingroup libtensor_core
+ **/
+template<typename T>
+class ooc_allocator {
+public:
+    typedef ooc_memory::block *pointer_type; //!< Pointer type
+
+public:
+    static const pointer_type invalid_pointer; //!< Invalid pointer constant
+
+public:
+    /** \brief Initializes the memory manager
+
+        \param base_sz Exponential base for block size increment (unused).
+        \param min_sz Smallest block size in data elements (unused).
+        \param max_sz Largest block size in data elements (unused).
+        \param mem_limit Memory limit in data elements.
+        \param prefix Directory for the page file.
+     **/
+    static void init(size_t base_sz, size_t min_sz, size_t max_sz,
+        size_t mem_limit, const char *prefix = 0) {
+
+        get_memory().init(mem_limit * sizeof(T), prefix);
+    }
+
+    /** \brief Shuts down the memory manager
+
+        This method frees all the memory and closes the page file.
+     **/
+    static void shutdown() {
+        get_memory().shutdown();
+    }
+
+    /** \brief Returns the real size of a block, in bytes, including alignment
+        \param sz Block size in units of T.
+     **/
+    static size_t get_block_size(size_t sz) {
+        return sz * sizeof(T);
+    }
+
+    /** \brief Allocates a block of memory
+        \param sz Block size (in units of type T).
+        \return Pointer to the block of memory.
+     **/
+    static pointer_type allocate(size_t sz) {
+        return get_memory().allocate(sz * sizeof(T));
+    }
+
+    /** \brief Deallocates (frees) a block of memory previously
+            allocated using allocate()
+        \param p Pointer to the block of memory.
+     **/
+    static void deallocate(pointer_type p) {
+        if(p) get_memory().deallocate(p);
+    }
+
+    /** \brief Starts reading a block back from the page file
+        \param p Pointer to the block of memory.
+     **/
+    static void prefetch(pointer_type p) {
+        get_memory().prefetch(p);
+    }
+
+    /** \brief Locks a block of memory in physical space for read-only
+        \param p Pointer to the block of memory.
+        \return Constant physical pointer to the memory.
+     **/
+    static const T *lock_ro(pointer_type p) {
+        return reinterpret_cast<const T*>(get_memory().lock(p, false));
+    }
+
+    /** \brief Unlocks a block of memory previously locked by lock_ro()
+        \param p Pointer to the block of memory.
+     **/
+    static void unlock_ro(pointer_type p) {
+        get_memory().unlock(p);
+    }
+
+    /** \brief Locks a block of memory in physical space for read-write
+        \param p Pointer to the block of memory.
+        \return Physical pointer to the memory.
+     **/
+    static T *lock_rw(pointer_type p) {
+        return reinterpret_cast<T*>(get_memory().lock(p, true));
+    }
+
+    /** \brief Unlocks a block of memory previously locked by lock_rw()
+        \param p Pointer to the block of memory.
+     **/
+    static void unlock_rw(pointer_type p) {
+        get_memory().unlock(p);
+    }
+
+    /** \brief Sets a priority flag on a memory block
+        \param p Pointer to a block of memory.
+     **/
+    static void set_priority(pointer_type p) {
+        get_memory().set_priority(p, true);
+    }
+
+    /** \brief Unsets a priority flag on a memory block
+        \param p Pointer to a block of memory.
+     **/
+    static void unset_priority(pointer_type p) {
+        get_memory().set_priority(p, false);
+    }
+
+    /** \brief Enables or disables the compression of evicted blocks
+            (after init())
+        \param mode Compression mode (ooc_memory::COMPRESS_NONE,
+            ooc_memory::COMPRESS_LOSSLESS, or ooc_memory::COMPRESS_LOSSY;
+            the latter only for T = double).
+        \param tol Largest absolute error for lossy compression.
+     **/
+    static void set_compression(int mode, double tol = 0.0) {
+        get_memory().set_compression(mode, sizeof(T), tol);
+    }
+
+    /** \brief Returns the statistics of the memory manager
+     **/
+    static ooc_memory::stats get_stats() {
+        return get_memory().get_stats();
+    }
+
+    /** \brief Prints the statistics of the memory manager
+     **/
+    static void print_stats(std::ostream &os) {
+        get_memory().print_stats(os);
+    }
+
+private:
+    static ooc_memory &get_memory() {
+        static ooc_memory mem;
+        return mem;
+    }
+
+};
+
+
+template<typename T>
+const typename ooc_allocator<T>::pointer_type
+    ooc_allocator<T>::invalid_pointer = 0;
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_OOC_ALLOCATOR_H
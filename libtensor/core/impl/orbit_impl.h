@@ -99,7 +99,7 @@ orbit<N, T>::orbit(const symmetry<N, T> &sym, const index<N> &idx,
     if(!compute_allowed) m_allowed = false;
 
     abs_index<N> aidx0(idx, m_dims);
-    build_orbit(sym, aidx0);
+    make_orbit(sym, aidx0, compute_allowed);
     abs_index<N>::get_index(m_orb.begin()->first, m_dims, m_cidx);
 
     if(!compute_allowed) m_allowed = true;
@@ -121,7 +121,7 @@ orbit<N, T>::orbit(const symmetry<N, T> &sym, size_t aidx,
     if(!compute_allowed) m_allowed = false;
 
     abs_index<N> aidx0(aidx, m_dims);
-    build_orbit(sym, aidx0);
+    make_orbit(sym, aidx0, compute_allowed);
     abs_index<N>::get_index(m_orb.begin()->first, m_dims, m_cidx);
 
     if(!compute_allowed) m_allowed = true;
@@ -205,6 +205,24 @@ const tensor_transf<N, T> &orbit<N, T>::get_transf(const iterator &i) const {
 }
 
 
+template<size_t N, typename T>
+void orbit<N, T>::make_orbit(const symmetry<N, T> &sym,
+    const abs_index<N> &aidx, bool compute_allowed) {
+
+    orbit_cache<N, T> &cache = sym.get_orbit_cache();
+
+    bool allowed = true;
+    if(cache.get_orbit(aidx.get_abs_index(), compute_allowed, m_orb, m_tr,
+        allowed)) {
+        if(compute_allowed) m_allowed = allowed;
+        return;
+    }
+
+    build_orbit(sym, aidx);
+    cache.set_orbit(m_orb, m_tr, m_allowed, compute_allowed);
+}
+
+
 template<size_t N, typename T>
 void orbit<N, T>::build_orbit(const symmetry<N, T> &sym,
     const abs_index<N> &aidx) {
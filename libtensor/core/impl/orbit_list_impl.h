@@ -69,6 +69,29 @@ orbit_list<N, T>::orbit_list(const symmetry<N, T> &sym) :
 }
 
 
+template<size_t N, typename T>
+orbit_list<N, T>::orbit_list(const symmetry<N, T> &sym,
+    const std::vector<size_t> &blst) :
+
+    m_dims(sym.get_bis().get_block_index_dims()),
+    m_mdims(m_dims, true) {
+
+    orbit_list::start_timer("sparse");
+
+    std::set<size_t> vis;
+    for(typename std::vector<size_t>::const_iterator i = blst.begin();
+        i != blst.end(); ++i) {
+
+        if(vis.count(*i) > 0) continue;
+        size_t acidx;
+        if(mark_orbit(sym, *i, vis, acidx)) m_orb.push_back(acidx);
+    }
+    std::sort(m_orb.begin(), m_orb.end());
+
+    orbit_list::stop_timer("sparse");
+}
+
+
 template<size_t N, typename T>
 bool orbit_list<N, T>::mark_orbit(const symmetry<N, T> &sym, size_t aidx0,
     std::vector<char> &chk) {
@@ -111,6 +134,47 @@ bool orbit_list<N, T>::mark_orbit(const symmetry<N, T> &sym, size_t aidx0,
 }
 
 
+template<size_t N, typename T>
+bool orbit_list<N, T>::mark_orbit(const symmetry<N, T> &sym, size_t aidx0,
+    std::set<size_t> &vis, size_t &acidx) {
+
+    std::vector<size_t> &q = orbit_list_buffer::get_q();
+
+    bool allowed = true;
+    q.clear();
+    q.push_back(aidx0);
+    vis.insert(aidx0);
+    acidx = aidx0;
+
+    index<N> idx;
+    while(!q.empty()) {
+
+        size_t aidx = q.back();
+        q.pop_back();
+        if(aidx < acidx) acidx = aidx;
+        abs_index<N>::get_index(aidx, m_mdims, idx);
+
+        for(typename symmetry<N, T>::iterator iset = sym.begin();
+            iset != sym.end(); ++iset) {
+
+            const symmetry_element_set<N, T> &eset = sym.get_subset(iset);
+            for(typename symmetry_element_set<N, T>::const_iterator ielem =
+                eset.begin(); ielem != eset.end(); ++ielem) {
+
+                const symmetry_element_i<N, T> &elem = eset.get_elem(ielem);
+                if(allowed) allowed = elem.is_allowed(idx);
+                index<N> idx2(idx);
+                elem.apply(idx2);
+                size_t aidx2 = abs_index<N>::get_abs_index(idx2, m_dims);
+                if(vis.insert(aidx2).second) q.push_back(aidx2);
+            }
+        }
+    }
+
+    return allowed;
+}
+
+
 } // namespace libtensor
 
 #endif // LIBTENSOR_ORBIT_LIST_IMPL_H
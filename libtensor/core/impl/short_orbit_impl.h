@@ -56,7 +56,7 @@ short_orbit<N, T>::short_orbit(const symmetry<N, T> &sym, const index<N> &idx,
     //  symmetry_element_i::is_allowed
     if(!compute_allowed) m_allowed = false;
 
-    find_cindex(sym, abs_index<N>::get_abs_index(idx, m_dims));
+    find_cindex(sym, abs_index<N>::get_abs_index(idx, m_dims), compute_allowed);
     abs_index<N>::get_index(m_acidx, m_mdims, m_cidx);
 
     if(!compute_allowed) m_allowed = true;
@@ -78,7 +78,7 @@ short_orbit<N, T>::short_orbit(const symmetry<N, T> &sym, size_t aidx,
     //  symmetry_element_i::is_allowed
     if(!compute_allowed) m_allowed = false;
 
-    find_cindex(sym, aidx);
+    find_cindex(sym, aidx, compute_allowed);
     abs_index<N>::get_index(m_acidx, m_mdims, m_cidx);
 
     if(!compute_allowed) m_allowed = true;
@@ -88,7 +88,16 @@ short_orbit<N, T>::short_orbit(const symmetry<N, T> &sym, size_t aidx,
 
 
 template<size_t N, typename T>
-void short_orbit<N, T>::find_cindex(const symmetry<N, T> &sym, size_t aidx) {
+void short_orbit<N, T>::find_cindex(const symmetry<N, T> &sym, size_t aidx,
+    bool compute_allowed) {
+
+    orbit_cache<N, T> &cache = sym.get_orbit_cache();
+
+    bool allowed = true;
+    if(cache.get_canonical(aidx, compute_allowed, m_acidx, allowed)) {
+        if(compute_allowed) m_allowed = allowed;
+        return;
+    }
 
     std::vector<size_t> &v1 = short_orbit_buffer::get_v1();
     std::vector<size_t> &v2 = short_orbit_buffer::get_v2();
@@ -146,6 +155,7 @@ void short_orbit<N, T>::find_cindex(const symmetry<N, T> &sym, size_t aidx) {
     }
 
     m_acidx = v1[0];
+    cache.set_canonical(v1, m_acidx, m_allowed, compute_allowed);
 
     v1.clear();
     v2.clear();
@@ -0,0 +1,452 @@
+#ifndef LIBTENSOR_SLAB_ALLOCATOR_H
+#define LIBTENSOR_SLAB_ALLOCATOR_H
+
+#include <new>
+#include <vector>
+#include <libutil/threads/auto_lock.h>
+#include <libutil/threads/mutex.h>
+#include <libutil/threads/tls.h>
+#include <libutil/thread_pool/cpu_topology.h>
+#include <libutil/thread_pool/thread_pool.h>
+#include "../aligned_memory.h"
+
+namespace libtensor {
+
+
+/** \brief Allocator that serves blocks from size classes carved out of
+        large slabs
+    \tparam T Data type.
+
+    Requested sizes are rounded up to size classes min_sz * base_sz^k up to
+    max_sz (in data elements, as given to init()). Blocks of each class are
+    carved out of slabs of several megabytes obtained from the system, so
+    the system allocator sees few large requests instead of many small ones.
+    Blocks larger than max_sz or than a slab are allocated individually.
+    Slabs and individual blocks come from aligned_memory, so they may be
+    backed by huge pages, and every block is aligned to 64 bytes.
+
+    Each thread keeps its own lists of free blocks, so most allocations and
+    deallocations do not take any locks. When a thread's list grows too
+    long, half of it is moved to the shared list of the class. Slabs whose
+    blocks are all in the shared lists are returned to the system together
+    when the shared lists hold too much memory (see trim()), and all slabs
+    are released by shutdown().
+
+    Before init() is called, and after shutdown(), all blocks are allocated
+    individually.
+
+    \ingroup libtensor_core
+ **/
+template<typename T>
+class slab_allocator {
+public:
+    typedef T *pointer_type; //!< Pointer type
+
+public:
+    static const pointer_type invalid_pointer; //!< Invalid pointer constant
+
+private:
+    struct slab;
+
+    /** \brief Header placed in front of each block (padded to keep
+            blocks aligned to 64 bytes)
+     **/
+    union header {
+        struct {
+            slab *s; //!< Slab of the block (null if allocated individually)
+            size_t cls; //!< Size class
+        } h;
+        char pad[64];
+    };
+
+    /** \brief Free block in a list
+     **/
+    struct free_block {
+        free_block *next;
+    };
+
+    /** \brief Slab (followed by its blocks)
+     **/
+    struct slab {
+        slab *prev, *next; //!< Neighbors in the list of all slabs
+        size_t cls; //!< Size class
+        size_t nblocks; //!< Number of blocks
+        size_t nfree; //!< Number of blocks in shared lists (used by trim())
+        char pad[64 - 2 * sizeof(slab*) - 3 * sizeof(size_t)];
+    };
+
+    /** \brief Free blocks of one size class
+     **/
+    struct free_list {
+        free_block *head;
+        size_t count;
+        free_list() : head(0), count(0) { }
+    };
+
+    /** \brief Free lists of a thread
+     **/
+    struct thread_cache {
+        size_t gen; //!< Generation of the allocator the lists belong to
+        std::vector<free_list> lists;
+        thread_cache() : gen(0) { }
+    };
+
+    enum {
+        k_slab_bytes = 4 * 1024 * 1024, //!< Target size of a slab
+        k_batch_bytes = 512 * 1024 //!< Bytes moved between lists at once
+    };
+
+private:
+    static std::vector<size_t> m_sizes; //!< Sizes of classes (in elements)
+    static std::vector<free_list> m_lists; //!< Shared free lists
+    static slab *m_slabs; //!< List of all slabs
+    static size_t m_gen; //!< Generation (incremented by init and shutdown)
+    static size_t m_free_bytes; //!< Bytes in shared free lists
+    static size_t m_trim_bytes; //!< Free bytes that trigger trim()
+    static size_t m_trim_min; //!< Minimum trim threshold
+    static libutil::mutex m_lock; //!< Lock on the shared state
+
+public:
+    /** \brief Initializes the allocator and sets up size classes
+
+        \param base_sz Exponential base for block size increment.
+        \param min_sz Smallest block size in data elements.
+        \param max_sz Largest block size in data elements.
+        \param mem_limit Memory limit in data elements.
+     **/
+    static void init(size_t base_sz, size_t min_sz, size_t max_sz,
+        size_t mem_limit, const char *prefix = 0) {
+
+        shutdown();
+
+        libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+        if(base_sz < 2) base_sz = 2;
+        if(min_sz < 1) min_sz = 1;
+        for(size_t sz = min_sz; sz <= max_sz; sz *= base_sz) {
+            if(sz * sizeof(T) + sizeof(header) > k_slab_bytes) break;
+            m_sizes.push_back(sz);
+        }
+        m_lists.resize(m_sizes.size());
+
+        //  Release memory once the free blocks reach a quarter of the limit
+        m_trim_min = mem_limit / 4 * sizeof(T);
+        if(m_trim_min < 16 * k_slab_bytes) m_trim_min = 16 * k_slab_bytes;
+        m_trim_bytes = m_trim_min;
+    }
+
+    /** \brief Shuts down the allocator
+
+        This method frees all the memory allocated by the allocator.
+     **/
+    static void shutdown() {
+
+        libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+        while(m_slabs) {
+            slab *s = m_slabs;
+            m_slabs = s->next;
+            aligned_memory::deallocate(s);
+        }
+        m_sizes.clear();
+        m_lists.clear();
+        m_free_bytes = 0;
+        m_gen++;
+    }
+
+    /** \brief Returns the real size of a block, in bytes, including alignment
+        \param sz Block size in units of T.
+     **/
+    static size_t get_block_size(size_t sz) {
+        size_t cls = find_class(sz);
+        return (cls < m_sizes.size() ? m_sizes[cls] : sz) * sizeof(T);
+    }
+
+    /** \brief Allocates a block of memory
+        \param sz Block size (in units of type T).
+        \return Pointer to the block of memory.
+     **/
+    static pointer_type allocate(size_t sz) {
+
+        size_t cls = find_class(sz);
+        if(cls == m_sizes.size()) return allocate_large(sz);
+
+        free_list &l = get_cache().lists[cls];
+        if(l.head == 0) refill(l, cls);
+        free_block *b = l.head;
+        l.head = b->next;
+        l.count--;
+        return reinterpret_cast<pointer_type>(b);
+    }
+
+    /** \brief Deallocates (frees) a block of memory previously
+            allocated using allocate()
+        \param p Pointer to the block of memory.
+     **/
+    static void deallocate(pointer_type p) {
+
+        if(p == 0) return;
+
+        header *hdr = reinterpret_cast<header*>(p) - 1;
+        if(hdr->h.s == 0) {
+            aligned_memory::deallocate(hdr);
+            return;
+        }
+
+        size_t cls = hdr->h.cls;
+        free_list &l = get_cache().lists[cls];
+        free_block *b = reinterpret_cast<free_block*>(p);
+        b->next = l.head;
+        l.head = b;
+        l.count++;
+        if(l.count > 2 * batch_size(cls)) spill(l, cls);
+    }
+
+    /** \brief Returns the slabs whose blocks are all free to the system
+     **/
+    static void trim() {
+
+        libutil::auto_lock<libutil::mutex> lock(m_lock);
+        do_trim();
+    }
+
+    /** \brief Prefetches a block of memory (does nothing in this
+            implementation)
+     **/
+    static void prefetch(pointer_type p) { }
+
+    /** \brief Locks a block of memory in physical space for read-only
+            (does nothing in this implementation)
+     **/
+    static const T *lock_ro(pointer_type p) {
+        return p;
+    }
+
+    /** \brief Unlocks a block of memory previously locked by lock_ro()
+            (does nothing in this implementation)
+     **/
+    static void unlock_ro(pointer_type p) { }
+
+    /** \brief Locks a block of memory in physical space for read-write
+            (does nothing in this implementation)
+     **/
+    static T *lock_rw(pointer_type p) {
+        return p;
+    }
+
+    /** \brief Unlocks a block of memory previously locked by lock_rw()
+            (does nothing in this implementation)
+     **/
+    static void unlock_rw(pointer_type p) { }
+
+    /** \brief Sets a priority flag on a memory block (stub)
+     **/
+    static void set_priority(pointer_type p) { }
+
+    /** \brief Unsets a priority flag on a memory block (stub)
+     **/
+    static void unset_priority(pointer_type p) { }
+
+private:
+    static size_t find_class(size_t sz) {
+        size_t cls = 0;
+        while(cls < m_sizes.size() && m_sizes[cls] < sz) cls++;
+        return cls;
+    }
+
+    static size_t block_bytes(size_t cls) {
+        //  Keep the headers of consecutive blocks aligned
+        size_t sz = m_sizes[cls] * sizeof(T);
+        return sizeof(header) * (2 + (sz - 1) / sizeof(header));
+    }
+
+    static size_t batch_size(size_t cls) {
+        size_t n = k_batch_bytes / block_bytes(cls);
+        return n > 0 ? n : 1;
+    }
+
+    static thread_cache &get_cache() {
+        thread_cache &tc = libutil::tls<thread_cache>::get_instance().get();
+        if(tc.gen != m_gen) {
+            //  Lists left from before the last init() or shutdown() point
+            //  to released slabs
+            libutil::auto_lock<libutil::mutex> lock(m_lock);
+            tc.lists.clear();
+            tc.lists.resize(m_sizes.size());
+            tc.gen = m_gen;
+        }
+        return tc;
+    }
+
+    static pointer_type allocate_large(size_t sz) {
+        void *ptr = aligned_memory::allocate(sizeof(header) + sz * sizeof(T));
+        header *hdr = static_cast<header*>(ptr);
+        hdr->h.s = 0;
+        hdr->h.cls = 0;
+        if(libutil::thread_pool::get_numa_node() >= 0) {
+            libutil::cpu_topology::first_touch(hdr + 1, sz * sizeof(T));
+        }
+        return reinterpret_cast<pointer_type>(hdr + 1);
+    }
+
+    /** \brief Fills an empty thread list from the shared list or a new slab
+     **/
+    static void refill(free_list &l, size_t cls) {
+
+        size_t n = batch_size(cls);
+        {
+            libutil::auto_lock<libutil::mutex> lock(m_lock);
+            free_list &g = m_lists[cls];
+            while(g.head && l.count < n) {
+                free_block *b = g.head;
+                g.head = b->next;
+                g.count--;
+                b->next = l.head;
+                l.head = b;
+                l.count++;
+                m_free_bytes -= block_bytes(cls);
+            }
+        }
+        if(l.head == 0) new_slab(l, cls);
+    }
+
+    /** \brief Moves half of a thread list to the shared list
+     **/
+    static void spill(free_list &l, size_t cls) {
+
+        size_t n = l.count / 2;
+
+        libutil::auto_lock<libutil::mutex> lock(m_lock);
+        free_list &g = m_lists[cls];
+        for(size_t i = 0; i < n; i++) {
+            free_block *b = l.head;
+            l.head = b->next;
+            l.count--;
+            b->next = g.head;
+            g.head = b;
+            g.count++;
+        }
+        m_free_bytes += n * block_bytes(cls);
+        if(m_free_bytes > m_trim_bytes) do_trim();
+    }
+
+    /** \brief Allocates a new slab and puts its blocks in a thread list
+     **/
+    static void new_slab(free_list &l, size_t cls) {
+
+        size_t bsz = block_bytes(cls);
+        size_t nblocks = (k_slab_bytes - sizeof(slab)) / bsz;
+        if(nblocks == 0) nblocks = 1;
+        void *ptr = aligned_memory::allocate(sizeof(slab) + nblocks * bsz);
+        if(libutil::thread_pool::get_numa_node() >= 0) {
+            libutil::cpu_topology::first_touch(ptr, sizeof(slab) +
+                nblocks * bsz);
+        }
+
+        slab *s = static_cast<slab*>(ptr);
+        s->cls = cls;
+        s->nblocks = nblocks;
+        s->nfree = 0;
+
+        char *p = reinterpret_cast<char*>(s + 1);
+        for(size_t i = 0; i < nblocks; i++, p += bsz) {
+            header *hdr = reinterpret_cast<header*>(p);
+            hdr->h.s = s;
+            hdr->h.cls = cls;
+            free_block *b = reinterpret_cast<free_block*>(hdr + 1);
+            b->next = l.head;
+            l.head = b;
+            l.count++;
+        }
+
+        libutil::auto_lock<libutil::mutex> lock(m_lock);
+        s->prev = 0;
+        s->next = m_slabs;
+        if(m_slabs) m_slabs->prev = s;
+        m_slabs = s;
+    }
+
+    /** \brief Releases slabs whose blocks are all in the shared lists
+            (called with the lock held)
+     **/
+    static void do_trim() {
+
+        for(slab *s = m_slabs; s; s = s->next) s->nfree = 0;
+        for(size_t cls = 0; cls < m_lists.size(); cls++) {
+            for(free_block *b = m_lists[cls].head; b; b = b->next) {
+                slab_of(b)->nfree++;
+            }
+        }
+
+        //  Unlink blocks of the slabs to be released
+
+        for(size_t cls = 0; cls < m_lists.size(); cls++) {
+            free_list &g = m_lists[cls];
+            free_block **pb = &g.head;
+            while(*pb) {
+                slab *s = slab_of(*pb);
+                if(s->nfree == s->nblocks) {
+                    *pb = (*pb)->next;
+                    g.count--;
+                    m_free_bytes -= block_bytes(cls);
+                } else {
+                    pb = &(*pb)->next;
+                }
+            }
+        }
+
+        slab *s = m_slabs;
+        while(s) {
+            slab *next = s->next;
+            if(s->nfree == s->nblocks) {
+                if(s->prev) s->prev->next = s->next;
+                else m_slabs = s->next;
+                if(s->next) s->next->prev = s->prev;
+                aligned_memory::deallocate(s);
+            }
+            s = next;
+        }
+
+        //  Avoid trimming again until enough memory is freed
+        m_trim_bytes = m_free_bytes + m_trim_min;
+    }
+
+    static slab *slab_of(free_block *b) {
+        return (reinterpret_cast<header*>(b) - 1)->h.s;
+    }
+
+};
+
+
+template<typename T>
+const typename slab_allocator<T>::pointer_type
+    slab_allocator<T>::invalid_pointer = 0;
+
+template<typename T>
+std::vector<size_t> slab_allocator<T>::m_sizes;
+
+template<typename T>
+std::vector<typename slab_allocator<T>::free_list> slab_allocator<T>::m_lists;
+
+template<typename T>
+typename slab_allocator<T>::slab *slab_allocator<T>::m_slabs = 0;
+
+template<typename T>
+size_t slab_allocator<T>::m_gen = 1;
+
+template<typename T>
+size_t slab_allocator<T>::m_free_bytes = 0;
+
+template<typename T>
+size_t slab_allocator<T>::m_trim_bytes = 0;
+
+template<typename T>
+size_t slab_allocator<T>::m_trim_min = 0;
+
+template<typename T>
+libutil::mutex slab_allocator<T>::m_lock;
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_SLAB_ALLOCATOR_H
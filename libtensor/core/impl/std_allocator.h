@@ -2,17 +2,21 @@
 #define LIBTENSOR_STD_ALLOCATOR_H
 
 #include <new>
+#include <libutil/thread_pool/cpu_topology.h>
+#include <libutil/thread_pool/thread_pool.h>
+#include "../aligned_memory.h"
 
 namespace libtensor {
 
 
-/** \brief Simple allocator based on C++ new and delete
-    \tparam T Data type.
+/** \brief Simple allocator based on system memory allocation
+    \tparam T Data type (plain old data).
 
     The allocator is the interface to the virtual memory state machine.
-    This simple implementation provides methods that are based on C++
-    new and delete operators. Because there is no virtual memory involved
-    here, the virtual and physical pointers are identical.
+    This simple implementation takes each block directly from the system
+    using aligned_memory, so blocks are aligned and large blocks are backed
+    by huge pages. Because there is no virtual memory involved here,
+    the virtual and physical pointers are identical.
 
     See method descriptions below for more information.
 
@@ -60,9 +64,18 @@ public:
     /** \brief Allocates a block of memory
         \param sz Block size (in units of type T).
         \return Pointer to the block of memory.
+
+        If called from a thread pool worker pinned to a NUMA node, the pages
+        of the block are touched right away, so they are placed in the node
+        of the worker.
      **/
     static pointer_type allocate(size_t sz) {
-        return new T[sz];
+        pointer_type p =
+            static_cast<pointer_type>(aligned_memory::allocate(sz * sizeof(T)));
+        if(libutil::thread_pool::get_numa_node() >= 0) {
+            libutil::cpu_topology::first_touch(p, sz * sizeof(T));
+        }
+        return p;
     }
 
     /** \brief Deallocates (frees) a block of memory previously
@@ -70,7 +83,7 @@ public:
         \param p Pointer to the block of memory.
      **/
     static void deallocate(pointer_type p) {
-        delete [] p;
+        aligned_memory::deallocate(p);
     }
 
     /** \brief Prefetches a block of memory (does nothing in this
@@ -0,0 +1,207 @@
+#ifndef LIBTENSOR_MEMORY_ACCOUNTING_H
+#define LIBTENSOR_MEMORY_ACCOUNTING_H
+
+#include <cstdlib> // for size_t
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <libutil/singleton.h>
+#include <libutil/threads/mutex.h>
+
+namespace libtensor {
+
+
+/** \brief Accounts for tensor memory by owner
+
+    When enabled, every allocation made through allocator<T> is charged to
+    the owners active in the calling thread at the time. Owners are named
+    scopes (see memory_owner) that nest: an allocation is charged to each of
+    the enclosing owners, so the figures for an operation include the memory
+    used by the operations it calls. Two kinds of owners are set up
+    automatically:
+     - operations, while the default timer of the operation class runs
+       (start_timer() to stop_timer(), named after k_clazz);
+     - block tensors that have been given a name (gen_block_tensor::set_name),
+       while they create blocks.
+    Owners are local to threads. Work done in the thread pool is charged to
+    the owners in the worker thread, not to the operation that submitted it.
+
+    For each owner, the accounting keeps the current and the peak number of
+    bytes, the number of allocations and deallocations, and the largest
+    allocations. A record with the name get_total_name() covers all
+    allocations whether owned or not.
+
+    Accounting is off by default and costs one test of a flag per
+    allocation and deallocation then. Allocations charged while it was on
+    are still released when they are freed after it has been turned off.
+    print() is meant to be called next to libutil::timings_store::print().
+
+    \ingroup libtensor_core
+ **/
+class memory_accounting : public libutil::singleton<memory_accounting> {
+    friend class libutil::singleton<memory_accounting>;
+
+public:
+    enum {
+        k_nlargest = 4 //!< Number of largest allocations kept per owner
+    };
+
+    /** \brief Memory used by one owner (in bytes)
+     **/
+    struct record {
+        size_t nbytes; //!< Currently allocated
+        size_t nbytes_peak; //!< Peak allocated
+        size_t nalloc; //!< Number of allocations
+        size_t nfree; //!< Number of deallocations
+        size_t largest[k_nlargest]; //!< Largest allocations, descending
+
+        record();
+    };
+
+private:
+    struct alloc_info {
+        size_t nbytes; //!< Size of the allocation
+        std::vector<size_t> owners; //!< Owners charged
+    };
+
+    typedef std::map<std::string, size_t> owner_map_type;
+    typedef std::map<const void*, alloc_info> alloc_map_type;
+
+private:
+    static volatile bool m_enabled; //!< Whether accounting is on
+    static volatile size_t m_nallocs; //!< Number of live allocations
+    libutil::mutex m_lock; //!< Lock on the records
+    owner_map_type m_owner_ids; //!< Owner names to indexes of records
+    std::vector<std::string> m_names; //!< Owner names
+    std::vector<record> m_records; //!< Records
+    alloc_map_type m_allocs; //!< Live allocations
+
+protected:
+    memory_accounting();
+
+public:
+    /** \brief Turns accounting on
+     **/
+    static void enable() {
+        get_instance();
+        m_enabled = true;
+    }
+
+    /** \brief Turns accounting off (existing records are kept)
+     **/
+    static void disable() {
+        m_enabled = false;
+    }
+
+    /** \brief Returns whether accounting is on
+     **/
+    static bool is_enabled() {
+        return m_enabled;
+    }
+
+    /** \brief Returns whether deallocations have to be reported, i.e.
+            accounting is on or some live allocations are still charged
+     **/
+    static bool is_tracking() {
+        return m_enabled || m_nallocs > 0;
+    }
+
+    /** \brief Returns the name of the record that covers all allocations
+     **/
+    static const char *get_total_name() {
+        return "(total)";
+    }
+
+    /** \brief Enters an owner scope in the current thread
+     **/
+    static void push_owner(const char *name);
+
+    /** \brief Leaves an owner scope in the current thread
+
+        Scopes that were entered after this one and not left (for instance,
+        because of an exception) are left as well. Unknown names are
+        ignored.
+     **/
+    static void pop_owner(const char *name);
+
+    /** \brief Charges an allocation to the current owners
+        \param p Allocated block (any unique pointer-sized handle).
+        \param sz Size in bytes.
+
+        If a live allocation with the same handle is still charged (its
+        release was missed), it is released first.
+     **/
+    static void on_allocate(const void *p, size_t sz);
+
+    /** \brief Releases an allocation charged by on_allocate(), also
+            when accounting has been turned off since (see is_tracking())
+        \param p Block.
+     **/
+    static void on_deallocate(const void *p);
+
+    /** \brief Forgets all records (live allocations stay charged to
+            their owners, with their peaks reset to the current values)
+     **/
+    static void reset();
+
+    /** \brief Returns the names of all owners with records
+     **/
+    static void get_owners(std::vector<std::string> &owners);
+
+    /** \brief Returns the record of an owner (zero if there is none)
+     **/
+    static record get_record(const std::string &owner);
+
+    /** \brief Prints the records of all owners
+     **/
+    static void print(std::ostream &os);
+
+private:
+    size_t get_owner_id(const std::string &name);
+    void release(alloc_map_type::iterator i);
+
+};
+
+
+/** \brief Makes a memory owner active in the current thread for the lifetime
+        of the object
+
+    Does nothing unless memory accounting is enabled when the object is
+    created.
+
+    \sa memory_accounting
+
+    \ingroup libtensor_core
+ **/
+class memory_owner {
+private:
+    const char *m_name; //!< Owner name (null if inactive)
+
+public:
+    /** \brief Enters the owner scope
+        \param name Owner name (must outlive the object).
+     **/
+    memory_owner(const char *name) : m_name(0) {
+        if(memory_accounting::is_enabled() && name && name[0] != '\0') {
+            m_name = name;
+            memory_accounting::push_owner(m_name);
+        }
+    }
+
+    /** \brief Leaves the owner scope
+     **/
+    ~memory_owner() {
+        if(m_name) memory_accounting::pop_owner(m_name);
+    }
+
+private:
+    memory_owner(const memory_owner&);
+    const memory_owner &operator=(const memory_owner&);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_MEMORY_ACCOUNTING_H
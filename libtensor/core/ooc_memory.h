@@ -0,0 +1,207 @@
+#ifndef LIBTENSOR_OOC_MEMORY_H
+#define LIBTENSOR_OOC_MEMORY_H
+
+#include <deque>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <libutil/threads/cond.h>
+#include <libutil/threads/mutex.h>
+#include <libutil/threads/thread.h>
+
+namespace libtensor {
+
+
+/** \brief Out-of-core memory manager with a page file
+
+    Blocks of memory are kept in RAM while they are locked or while
+    the total size of resident blocks is within the memory limit. Beyond
+    the limit, unlocked blocks are evicted to a page file in the order of
+    least recent use. Blocks with the priority flag (see set_priority()) are
+    evicted only when there are no other candidates. A block is written to
+    the page file only if it has been locked for writing since it was last
+    written; otherwise the copy in the file is still valid, and the memory
+    is simply released. Blocks that have never been written have undefined
+    contents and are not saved either.
+
+    With compression enabled (see set_compression()), evicted blocks are
+    first compressed in memory (see block_codec) and only the compressed
+    blocks that are least recently used are moved to the page file, in
+    compressed form. Locking a compressed block restores it; the compressed
+    copy is kept until the block is locked for writing, so evicting the block
+    again costs nothing. Blocks that do not compress are written to the page
+    file directly.
+
+    A block gets its memory on the first lock. Locking a block that has
+    been evicted reads it back from the page file. prefetch() queues such
+    reads for a background I/O thread, so the data may already be in memory
+    when the block is locked.
+
+    If every resident block is locked, the limit is exceeded temporarily
+    rather than failing the request.
+
+    The page file is created under a given directory and removed from
+    the file system right away, so it disappears when the process exits.
+    Space in the file is reused for blocks of the same or smaller size.
+
+    \sa ooc_allocator
+
+    \ingroup libtensor_core
+ **/
+class ooc_memory {
+public:
+    static const char k_clazz[]; //!< Class name
+
+public:
+    struct block; //!< Block of memory (opaque)
+
+    enum {
+        COMPRESS_NONE, //!< No compression
+        COMPRESS_LOSSLESS, //!< Lossless compression
+        COMPRESS_LOSSY //!< Compression of doubles with an error bound
+    };
+
+    /** \brief Statistics
+     **/
+    struct stats {
+        size_t nbytes_limit; //!< Memory limit
+        size_t nbytes_resident; //!< Bytes in memory
+        size_t nbytes_file; //!< Size of the page file
+        size_t nblocks; //!< Number of blocks
+        size_t nevict; //!< Number of evictions
+        size_t nwrite; //!< Number of blocks written to the file
+        size_t nread; //!< Number of blocks read from the file
+        size_t nprefetch; //!< Number of blocks read in advance
+        size_t nbytes_written; //!< Bytes written to the file
+        size_t nbytes_read; //!< Bytes read from the file
+        size_t nbytes_compressed; //!< Compressed bytes in memory
+        size_t ncompress; //!< Number of blocks compressed
+        size_t ndecompress; //!< Number of blocks restored
+        size_t nbytes_zin; //!< Bytes of data compressed
+        size_t nbytes_zout; //!< Bytes of compressed data produced
+        double time_compress; //!< Time spent compressing (s)
+        double time_decompress; //!< Time spent restoring (s)
+    };
+
+private:
+    /** \brief Background thread that serves prefetch requests
+     **/
+    class io_thread : public libutil::thread {
+    private:
+        ooc_memory &m_mem;
+
+    public:
+        io_thread(ooc_memory &mem) : m_mem(mem) { }
+        virtual void run() {
+            m_mem.io_main();
+        }
+    };
+
+private:
+    libutil::mutex m_lock; //!< Lock on the state
+    size_t m_limit; //!< Memory limit in bytes (0 for none)
+    size_t m_resident; //!< Bytes in memory
+    block *m_all; //!< List of all blocks
+    std::list<block*> m_lru; //!< Unlocked blocks, most recent first
+    std::list<block*> m_lru_prio; //!< Unlocked priority blocks
+    std::list<block*> m_lru_z; //!< Blocks only in compressed form
+    int m_zmode; //!< Compression mode
+    size_t m_elsz; //!< Size of data elements
+    double m_ztol; //!< Error bound for lossy compression
+    int m_fd; //!< Page file descriptor (-1 if none)
+    size_t m_fend; //!< End of the used space in the page file
+    std::multimap<size_t, size_t> m_holes; //!< Free space (size, offset)
+    std::deque<block*> m_queue; //!< Prefetch queue
+    io_thread *m_io; //!< I/O thread
+    libutil::cond m_iosig; //!< Signals the I/O thread
+    volatile bool m_stop; //!< Stops the I/O thread
+    stats m_stats; //!< Statistics
+
+public:
+    /** \brief Initializes the memory manager (no limit, no page file)
+     **/
+    ooc_memory();
+
+    /** \brief Releases all memory and closes the page file
+     **/
+    ~ooc_memory();
+
+    /** \brief Sets the memory limit and creates the page file
+        \param mem_limit Memory limit in bytes (0 for no limit).
+        \param pfprefix Directory for the page file (null for $TMPDIR or
+            /tmp).
+     **/
+    void init(size_t mem_limit, const char *pfprefix);
+
+    /** \brief Enables or disables the compression of evicted blocks
+        \param mode Compression mode (COMPRESS_NONE, COMPRESS_LOSSLESS,
+            or COMPRESS_LOSSY).
+        \param elsz Size of data elements in bytes (COMPRESS_LOSSY requires
+            that all data are doubles).
+        \param tol Largest absolute error for COMPRESS_LOSSY.
+     **/
+    void set_compression(int mode, size_t elsz, double tol = 0.0);
+
+    /** \brief Releases all the blocks and closes the page file
+     **/
+    void shutdown();
+
+    /** \brief Creates a block
+        \param sz Size of the block in bytes.
+     **/
+    block *allocate(size_t sz);
+
+    /** \brief Destroys a block (must not be locked)
+     **/
+    void deallocate(block *b);
+
+    /** \brief Requests that an evicted block be read back in the background
+     **/
+    void prefetch(block *b);
+
+    /** \brief Locks a block in memory and returns the pointer to its data
+        \param b Block.
+        \param rw Whether the block will be modified.
+     **/
+    char *lock(block *b, bool rw);
+
+    /** \brief Unlocks a block previously locked by lock()
+     **/
+    void unlock(block *b);
+
+    /** \brief Sets or removes the priority flag on a block
+     **/
+    void set_priority(block *b, bool prio);
+
+    /** \brief Returns statistics
+     **/
+    stats get_stats();
+
+    /** \brief Prints statistics
+     **/
+    void print_stats(std::ostream &os);
+
+private:
+    void make_room(size_t sz);
+    bool evict(block *b);
+    bool compress_block(block *b);
+    bool write_block(block *b, const char *p, size_t sz, bool z);
+    void load_block(block *b);
+    void wait_loaded(block *b);
+    void add_to_lru(block *b);
+    void remove_from_lru(block *b);
+    void release_file_space(block *b);
+    void io_main();
+
+private:
+    ooc_memory(const ooc_memory&);
+    const ooc_memory &operator=(const ooc_memory&);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_OOC_MEMORY_H
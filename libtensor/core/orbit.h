@@ -35,8 +35,10 @@ namespace libtensor {
     allowed, otherwise the orbit is not allowed and all its blocks are zero.
 
     The algorithm runs in a constant time, which depends on the size of
-    the symmetry group. The algorithm is thread-safe as long as the symmetry
-    is not altered in the course of constructing the orbit.
+    the symmetry group. Orbits are stored in the orbit cache of the symmetry
+    group, so constructing the same orbit again is a lookup. The algorithm is
+    thread-safe as long as the symmetry is not altered in the course of
+    constructing the orbit.
 
     \sa symmetry_i, orbit_list
 
@@ -161,6 +163,8 @@ public:
     //@}
 
 private:
+    void make_orbit(const symmetry<N, T> &sym, const abs_index<N> &aidx,
+        bool compute_allowed);
     void build_orbit(const symmetry<N, T> &sym, const abs_index<N> &aidx);
 
 };
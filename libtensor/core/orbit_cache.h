@@ -0,0 +1,314 @@
+#ifndef LIBTENSOR_ORBIT_CACHE_H
+#define LIBTENSOR_ORBIT_CACHE_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include <libutil/threads/rwlock.h>
+#include "noncopyable.h"
+#include "tensor_transf_double.h"
+
+namespace libtensor {
+
+
+/** \brief Cache of orbits computed in a symmetry group
+    \tparam N Tensor order.
+    \tparam T Tensor element type.
+
+    Each symmetry object owns one orbit cache, which is filled by the orbit
+    and short_orbit algorithms. The cache maps the absolute value of a block
+    index to the canonical index of its orbit and, if known, the whole orbit
+    with the transformations from the canonical block to each block. Repeated
+    requests for the same orbit then become a lookup.
+
+    Whether the orbit is allowed by symmetry is only stored if it was
+    computed. Requests that need this information are served from the cache
+    only if it is available.
+
+    The cache is emptied each time the symmetry group is changed. When the
+    number of cached indexes exceeds the limit, the entire cache is discarded.
+
+    The cache is thread-safe.
+
+    \sa orbit, short_orbit, symmetry
+
+    \ingroup libtensor_core
+ **/
+template<size_t N, typename T>
+class orbit_cache : public noncopyable {
+public:
+    static const char *k_clazz; //!< Class name
+
+    //! Default limit on the number of cached indexes
+    static const size_t k_default_max_size = 262144;
+
+public:
+    typedef std::pair<size_t, size_t> itr_pair_type;
+    typedef tensor_transf<N, T> tensor_transf_type;
+
+private:
+    enum {
+        ALLOWED_UNKNOWN = -1,
+        ALLOWED_NO = 0,
+        ALLOWED_YES = 1
+    };
+
+    struct canon_data {
+        size_t acidx; //!< Absolute value of canonical index
+        int allowed; //!< Whether the orbit is allowed
+    };
+
+    struct orbit_data {
+        std::vector<itr_pair_type> orb; //!< Sorted indexes in the orbit
+        std::vector<tensor_transf_type> tr; //!< Transformations
+        int allowed; //!< Whether the orbit is allowed
+    };
+
+private:
+    libutil::rwlock m_lock; //!< Read-write lock
+    std::map<size_t, canon_data> m_canon; //!< Canonical indexes
+    std::map<size_t, orbit_data> m_orbits; //!< Orbits by canonical index
+    size_t m_max_size; //!< Max number of cached indexes
+
+public:
+    /** \brief Initializes an empty cache
+     **/
+    orbit_cache() : m_max_size(k_default_max_size) { }
+
+    /** \brief Looks up the canonical index of the orbit containing a block
+        \param aidx Absolute value of the block index.
+        \param need_allowed Whether the allowed flag is required.
+        \param[out] acidx Absolute value of the canonical index.
+        \param[out] allowed Whether the orbit is allowed (if required).
+        \return True if found, false otherwise.
+     **/
+    bool get_canonical(size_t aidx, bool need_allowed, size_t &acidx,
+        bool &allowed);
+
+    /** \brief Stores the canonical index of an orbit
+        \param orb Absolute values of all indexes in the orbit.
+        \param acidx Absolute value of the canonical index.
+        \param allowed Whether the orbit is allowed.
+        \param allowed_known Whether the allowed flag has been computed.
+     **/
+    void set_canonical(const std::vector<size_t> &orb, size_t acidx,
+        bool allowed, bool allowed_known);
+
+    /** \brief Looks up the orbit containing a block
+        \param aidx Absolute value of the block index.
+        \param need_allowed Whether the allowed flag is required.
+        \param[out] orb Sorted absolute values of indexes in the orbit
+            paired with positions in the list of transformations.
+        \param[out] tr Transformations from the canonical block.
+        \param[out] allowed Whether the orbit is allowed (if required).
+        \return True if found, false otherwise.
+     **/
+    bool get_orbit(size_t aidx, bool need_allowed,
+        std::vector<itr_pair_type> &orb, std::vector<tensor_transf_type> &tr,
+        bool &allowed);
+
+    /** \brief Stores an orbit
+        \param orb Sorted absolute values of indexes in the orbit paired with
+            positions in the list of transformations.
+        \param tr Transformations from the canonical block.
+        \param allowed Whether the orbit is allowed.
+        \param allowed_known Whether the allowed flag has been computed.
+     **/
+    void set_orbit(const std::vector<itr_pair_type> &orb,
+        const std::vector<tensor_transf_type> &tr, bool allowed,
+        bool allowed_known);
+
+    /** \brief Removes all entries from the cache
+     **/
+    void clear();
+
+    /** \brief Returns the number of cached indexes
+     **/
+    size_t get_size();
+
+    /** \brief Sets the limit on the number of cached indexes (0 disables
+            the cache)
+     **/
+    void set_max_size(size_t max_size);
+
+private:
+    /** \brief Makes room for n new indexes, returns false if they do not
+            fit in the cache
+     **/
+    bool make_room(size_t n);
+
+};
+
+
+template<size_t N, typename T>
+const char *orbit_cache<N, T>::k_clazz = "orbit_cache<N, T>";
+
+
+template<size_t N, typename T>
+const size_t orbit_cache<N, T>::k_default_max_size;
+
+
+template<size_t N, typename T>
+bool orbit_cache<N, T>::get_canonical(size_t aidx, bool need_allowed,
+    size_t &acidx, bool &allowed) {
+
+    bool found = false;
+
+    m_lock.rdlock();
+    typename std::map<size_t, canon_data>::const_iterator i =
+        m_canon.find(aidx);
+    if(i != m_canon.end() &&
+        (!need_allowed || i->second.allowed != ALLOWED_UNKNOWN)) {
+        acidx = i->second.acidx;
+        allowed = (i->second.allowed == ALLOWED_YES);
+        found = true;
+    }
+    m_lock.unlock();
+
+    return found;
+}
+
+
+template<size_t N, typename T>
+void orbit_cache<N, T>::set_canonical(const std::vector<size_t> &orb,
+    size_t acidx, bool allowed, bool allowed_known) {
+
+    canon_data d;
+    d.acidx = acidx;
+    d.allowed = allowed_known ?
+        (allowed ? ALLOWED_YES : ALLOWED_NO) : ALLOWED_UNKNOWN;
+
+    m_lock.wrlock();
+    try {
+        if(make_room(orb.size())) {
+            for(size_t i = 0; i < orb.size(); i++) {
+                std::pair<typename std::map<size_t, canon_data>::iterator,
+                    bool> r = m_canon.insert(std::make_pair(orb[i], d));
+                if(!r.second && allowed_known) r.first->second = d;
+            }
+        }
+    } catch(...) {
+        m_lock.unlock();
+        throw;
+    }
+    m_lock.unlock();
+}
+
+
+template<size_t N, typename T>
+bool orbit_cache<N, T>::get_orbit(size_t aidx, bool need_allowed,
+    std::vector<itr_pair_type> &orb, std::vector<tensor_transf_type> &tr,
+    bool &allowed) {
+
+    bool found = false;
+
+    m_lock.rdlock();
+    try {
+        typename std::map<size_t, canon_data>::const_iterator i =
+            m_canon.find(aidx);
+        if(i != m_canon.end()) {
+            typename std::map<size_t, orbit_data>::const_iterator j =
+                m_orbits.find(i->second.acidx);
+            if(j != m_orbits.end() &&
+                (!need_allowed || j->second.allowed != ALLOWED_UNKNOWN)) {
+                orb = j->second.orb;
+                tr = j->second.tr;
+                allowed = (j->second.allowed == ALLOWED_YES);
+                found = true;
+            }
+        }
+    } catch(...) {
+        m_lock.unlock();
+        throw;
+    }
+    m_lock.unlock();
+
+    return found;
+}
+
+
+template<size_t N, typename T>
+void orbit_cache<N, T>::set_orbit(const std::vector<itr_pair_type> &orb,
+    const std::vector<tensor_transf_type> &tr, bool allowed,
+    bool allowed_known) {
+
+    if(orb.empty()) return;
+
+    canon_data d;
+    d.acidx = orb[0].first;
+    d.allowed = allowed_known ?
+        (allowed ? ALLOWED_YES : ALLOWED_NO) : ALLOWED_UNKNOWN;
+
+    m_lock.wrlock();
+    try {
+        if(make_room(orb.size())) {
+            for(size_t i = 0; i < orb.size(); i++) {
+                std::pair<typename std::map<size_t, canon_data>::iterator,
+                    bool> r = m_canon.insert(std::make_pair(orb[i].first, d));
+                if(!r.second && allowed_known) r.first->second = d;
+            }
+            std::pair<typename std::map<size_t, orbit_data>::iterator, bool>
+                r = m_orbits.insert(std::make_pair(d.acidx, orbit_data()));
+            orbit_data &od = r.first->second;
+            if(r.second || (allowed_known && od.allowed == ALLOWED_UNKNOWN)) {
+                od.orb = orb;
+                od.tr = tr;
+                od.allowed = d.allowed;
+            }
+        }
+    } catch(...) {
+        m_lock.unlock();
+        throw;
+    }
+    m_lock.unlock();
+}
+
+
+template<size_t N, typename T>
+void orbit_cache<N, T>::clear() {
+
+    m_lock.wrlock();
+    m_canon.clear();
+    m_orbits.clear();
+    m_lock.unlock();
+}
+
+
+template<size_t N, typename T>
+size_t orbit_cache<N, T>::get_size() {
+
+    m_lock.rdlock();
+    size_t sz = m_canon.size();
+    m_lock.unlock();
+    return sz;
+}
+
+
+template<size_t N, typename T>
+void orbit_cache<N, T>::set_max_size(size_t max_size) {
+
+    m_lock.wrlock();
+    m_max_size = max_size;
+    if(m_canon.size() > m_max_size) {
+        m_canon.clear();
+        m_orbits.clear();
+    }
+    m_lock.unlock();
+}
+
+
+template<size_t N, typename T>
+bool orbit_cache<N, T>::make_room(size_t n) {
+
+    if(n > m_max_size) return false;
+    if(m_canon.size() + n > m_max_size) {
+        m_canon.clear();
+        m_orbits.clear();
+    }
+    return true;
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_ORBIT_CACHE_H
@@ -3,6 +3,7 @@
 
 #include <cstdlib> // for size_t
 #include <algorithm> // for std::binary_search
+#include <set>
 #include <vector>
 #include <libtensor/timings.h>
 #include "abs_index.h"
@@ -22,6 +23,13 @@ namespace libtensor {
     indexes in that symmetry. The list of orbits represented by their canonical
     indexes can be then iterated over using STL-like iterators.
 
+    The default constructor goes through the entire block index space, which
+    requires one byte of scratch memory per block. When only a few blocks can
+    be non-zero, the list can be built from a list of candidate blocks
+    instead. Then only the orbits that contain at least one of the candidates
+    are enumerated, and the work and memory are proportional to the total
+    length of those orbits.
+
     \ingroup libtensor_core
  **/
 template<size_t N, typename T>
@@ -43,6 +51,14 @@ public:
      **/
     orbit_list(const symmetry<N, T> &sym);
 
+    /** \brief Constructs the list of orbits that contain at least one of
+            the candidate blocks
+        \param sym Symmetry group
+        \param blst Absolute indexes of candidate blocks (in any order,
+            need not be canonical)
+     **/
+    orbit_list(const symmetry<N, T> &sym, const std::vector<size_t> &blst);
+
     /** \brief Returns the number of orbits on the list
      **/
     size_t get_size() const {
@@ -95,6 +111,9 @@ private:
     bool mark_orbit(const symmetry<N, T> &sym, size_t aidx0,
         std::vector<char> &chk);
 
+    bool mark_orbit(const symmetry<N, T> &sym, size_t aidx0,
+        std::set<size_t> &vis, size_t &acidx);
+
 };
 
 
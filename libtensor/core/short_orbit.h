@@ -14,7 +14,8 @@ namespace libtensor {
 /** \brief Computes the canonical index from any index of an orbit
 
     This is a short version of the orbit algorithm to only compute the canonical
-    index from any index in the same orbit.
+    index from any index in the same orbit. The canonical indexes found are
+    memorized in the orbit cache of the symmetry group.
 
     \sa symmetry_i, orbit, orbit_list
 
@@ -72,7 +73,8 @@ public:
     }
 
 private:
-    void find_cindex(const symmetry<N, T> &sym, size_t aidx);
+    void find_cindex(const symmetry<N, T> &sym, size_t aidx,
+        bool compute_allowed);
 
 };
 
@@ -3,13 +3,20 @@
 
 #include <algorithm>
 #include <list>
+#include <libutil/threads/auto_lock.h>
+#include <libutil/threads/mutex.h>
 #include "../defs.h"
 #include "../exception.h"
 #include "block_index_space.h"
+#include "orbit_cache.h"
 #include "symmetry_element_set.h"
 
 namespace libtensor {
 
+
+class symmetry_operation_cache;
+
+
 /** \brief Tensor symmetry
     \tparam N Tensor order.
     \tparam T Tensor element type.
@@ -17,12 +24,23 @@ namespace libtensor {
 	The class represents the %symmetry of a (block) %tensor by storing
 	a list of %symmetry elements.
 
+	Each %symmetry object owns a cache of the orbits computed in it, which
+	is reset whenever the list of elements changes.
+
+	The fingerprint of a %symmetry object is a cheap identifier of its
+	current state. A new unique fingerprint is assigned each time the object
+	is modified, so two objects with the same fingerprint are guaranteed to
+	contain the same elements. Fingerprints are used to look up the results
+	of %symmetry operations (see symmetry_operation_cache).
+
 	TODO Move to folder symmetry.
 
     \ingroup libtensor_core
  **/
 template<size_t N, typename T>
 class symmetry {
+    friend class symmetry_operation_cache;
+
 public:
     static const char *k_clazz; //!< Class name
 
@@ -34,6 +52,11 @@ public:
 private:
     block_index_space<N> m_bis; //!< Block %index space
     std::list<symmetry_element_set<N, T>*> m_subsets; //!< Symmetry subsets
+    mutable orbit_cache<N, T> m_orbits; //!< Cache of orbits
+    size_t m_fprint; //!< Fingerprint of the current state
+
+    static libutil::mutex m_fprint_lock; //!< Lock for the last fingerprint
+    static size_t m_fprint_last; //!< Last assigned fingerprint
 
 public:
     //!    \name Construction and destruction
@@ -42,7 +65,8 @@ public:
     /** \brief Creates %symmetry using a given block %index space
         \param bis Block %index space.
      **/
-    symmetry(const block_index_space<N> &bis) : m_bis(bis) { }
+    symmetry(const block_index_space<N> &bis) :
+        m_bis(bis), m_fprint(make_fingerprint()) { }
 
     /** \brief Destructor
      **/
@@ -82,6 +106,19 @@ public:
      **/
     void clear() {
         remove_all();
+        m_fprint = make_fingerprint();
+    }
+
+    /** \brief Returns the fingerprint of the current state of this %symmetry
+     **/
+    size_t get_fingerprint() const {
+        return m_fprint;
+    }
+
+    /** \brief Returns the cache of orbits in this %symmetry
+     **/
+    orbit_cache<N, T> &get_orbit_cache() const {
+        return m_orbits;
     }
 
     //@}
@@ -89,6 +126,8 @@ public:
 private:
     void remove_all();
 
+    static size_t make_fingerprint();
+
 private:
     symmetry(const symmetry<N, T>&);
     const symmetry<N, T> &operator=(const symmetry<N, T>&);
@@ -100,6 +139,14 @@ template<size_t N, typename T>
 const char *symmetry<N, T>::k_clazz = "symmetry<N, T>";
 
 
+template<size_t N, typename T>
+libutil::mutex symmetry<N, T>::m_fprint_lock;
+
+
+template<size_t N, typename T>
+size_t symmetry<N, T>::m_fprint_last = 0;
+
+
 template<size_t N, typename T>
 symmetry<N, T>::~symmetry() {
 
@@ -110,6 +157,9 @@ symmetry<N, T>::~symmetry() {
 template<size_t N, typename T>
 void symmetry<N, T>::insert(const symmetry_element_i<N, T> &e) {
 
+    m_orbits.clear();
+    m_fprint = make_fingerprint();
+
     typename std::list<symmetry_element_set<N, T>*>::iterator i =
         m_subsets.begin();
     while(i != m_subsets.end() &&
@@ -125,6 +175,8 @@ void symmetry<N, T>::insert(const symmetry_element_i<N, T> &e) {
 template<size_t N, typename T>
 void symmetry<N, T>::remove_all() {
 
+    m_orbits.clear();
+
     if(m_subsets.empty()) return;
     for(typename std::list<symmetry_element_set<N, T>*>::iterator i =
         m_subsets.begin(); i != m_subsets.end(); i++) delete *i;
@@ -132,6 +184,14 @@ void symmetry<N, T>::remove_all() {
 }
 
 
+template<size_t N, typename T>
+size_t symmetry<N, T>::make_fingerprint() {
+
+    libutil::auto_lock<libutil::mutex> lock(m_fprint_lock);
+    return ++m_fprint_last;
+}
+
+
 } // namespace libtensor
 
 #endif // LIBTENSOR_SYMMETRY_H
@@ -1,6 +1,7 @@
 #ifndef LIBTENSOR_TOD_CONTRACT2_IMPL_H
 #define LIBTENSOR_TOD_CONTRACT2_IMPL_H
 
+#include <cmath> // for sqrt
 #include <cstring> // for memset
 #include <memory>
 #include <libtensor/core/allocator.h>
@@ -8,6 +9,7 @@
 #include <libtensor/core/contraction2_align.h>
 #include <libtensor/core/contraction2_list_builder.h>
 #include <libtensor/linalg/linalg.h>
+#include <libtensor/linalg/linalg_threads.h>
 #include <libtensor/kernels/kern_dadd1.h>
 #include <libtensor/kernels/kern_dcopy.h>
 #include <libtensor/kernels/kern_dmul2.h>
@@ -372,9 +374,17 @@ void tod_contract2<N, M, K>::perform_internal(aligned_args &ar,
 
         std::auto_ptr< kernel_base<linalg, 2, 1> > kern(
             kern_dmul2<linalg>::match(ar.d, loop_in, loop_out));
+
+        //  Borrow idle CPUs for large multiplications, the number of flops
+        //  is 2 * ni * nj * np = 2 * sqrt(|A| * |B| * |C|)
+        linalg_threads thr(2.0 * std::sqrt(double(dimsa1.get_size()) *
+            double(dimsb1.get_size()) * double(dimsc.get_size())));
+
         tod_contract2<N, M, K>::start_timer("kernel");
         tod_contract2<N, M, K>::start_timer(kern->get_name());
+        tod_contract2<N, M, K>::start_timer(thr.get_timer_name());
         loop_list_runner<linalg, 2, 1>(loop_in).run(0, r, *kern);
+        tod_contract2<N, M, K>::stop_timer(thr.get_timer_name());
         tod_contract2<N, M, K>::stop_timer("kernel");
         tod_contract2<N, M, K>::stop_timer(kern->get_name());
     }
@@ -0,0 +1,155 @@
+#ifndef LIBTENSOR_TOD_DIV_DIRSUM_IMPL_H
+#define LIBTENSOR_TOD_DIV_DIRSUM_IMPL_H
+
+#include <memory>
+#include <libtensor/core/bad_dimensions.h>
+#include <libtensor/linalg/linalg.h>
+#include <libtensor/kernels/kern_ddivsum2.h>
+#include <libtensor/kernels/loop_list_runner.h>
+#include "../dense_tensor_ctrl.h"
+#include "../to_dirsum_dims.h"
+#include "../tod_div_dirsum.h"
+
+namespace libtensor {
+
+
+template<size_t N, size_t M>
+const char *tod_div_dirsum<N, M>::k_clazz = "tod_div_dirsum<N, M>";
+
+
+template<size_t N, size_t M>
+tod_div_dirsum<N, M>::tod_div_dirsum(
+    dense_tensor_rd_i<k_orderc, double> &tn,
+    dense_tensor_rd_i<k_ordera, double> &ta,
+    const scalar_transf<double> &ka,
+    dense_tensor_rd_i<k_orderb, double> &tb,
+    const scalar_transf<double> &kb,
+    const permutation<k_orderc> &perms,
+    const tensor_transf_type &trc) :
+
+    m_tn(tn), m_ta(ta), m_tb(tb), m_ka(ka.get_coeff()), m_kb(kb.get_coeff()),
+    m_perms(perms), m_trc(trc), m_dimsc(m_tn.get_dims()) {
+
+    static const char *method = "tod_div_dirsum("
+        "dense_tensor_rd_i<N + M, double>&, dense_tensor_rd_i<N, double>&, "
+        "const scalar_transf<double>&, dense_tensor_rd_i<M, double>&, "
+        "const scalar_transf<double>&, const permutation<N + M>&, "
+        "const tensor_transf_type&)";
+
+    if(!to_dirsum_dims<N, M>(m_ta.get_dims(), m_tb.get_dims(), m_perms).
+        get_dimsc().equals(m_dimsc)) {
+        throw bad_dimensions(g_ns, k_clazz, method,
+            __FILE__, __LINE__, "tn, ta, tb");
+    }
+    m_dimsc.permute(m_trc.get_perm());
+}
+
+
+template<size_t N, size_t M>
+void tod_div_dirsum<N, M>::perform(bool zero,
+    dense_tensor_wr_i<k_orderc, double> &tc) {
+
+    static const char *method =
+            "perform(bool, dense_tensor_wr_i<N + M, double>&)";
+
+    if(!m_dimsc.equals(tc.get_dims())) {
+        throw bad_dimensions(g_ns, k_clazz, method,
+            __FILE__, __LINE__, "tc");
+    }
+
+    tod_div_dirsum<N, M>::start_timer();
+
+    try {
+
+        dense_tensor_rd_ctrl<k_orderc, double> cn(m_tn);
+        dense_tensor_rd_ctrl<k_ordera, double> ca(m_ta);
+        dense_tensor_rd_ctrl<k_orderb, double> cb(m_tb);
+        dense_tensor_wr_ctrl<k_orderc, double> cc(tc);
+
+        cn.req_prefetch();
+        ca.req_prefetch();
+        cb.req_prefetch();
+        cc.req_prefetch();
+
+        //  Index i of the result is index seqn[i] of the numerator, which
+        //  in turn is index seqs[seqn[i]] of the unpermuted direct sum
+
+        sequence<k_orderc, size_t> seqn(0), seqs(0);
+        for(size_t i = 0; i < k_orderc; i++) seqn[i] = seqs[i] = i;
+        m_trc.get_perm().apply(seqn);
+        m_perms.apply(seqs);
+
+        const dimensions<k_orderc> &dimsn = m_tn.get_dims();
+        const dimensions<k_ordera> &dimsa = m_ta.get_dims();
+        const dimensions<k_orderb> &dimsb = m_tb.get_dims();
+        const dimensions<k_orderc> &dimsc = tc.get_dims();
+
+        std::list< loop_list_node<3, 1> > loop_in, loop_out;
+        typename std::list< loop_list_node<3, 1> >::iterator inode =
+            loop_in.end();
+        for(size_t i = 0; i < k_orderc; i++) {
+            size_t in = seqn[i], is = seqs[in];
+            size_t inca, incb;
+            if(is < N) {
+                inca = dimsa.get_increment(is);
+                incb = 0;
+            } else {
+                inca = 0;
+                incb = dimsb.get_increment(is - N);
+            }
+            inode = loop_in.insert(loop_in.end(),
+                loop_list_node<3, 1>(dimsc[i]));
+            inode->stepa(0) = dimsn.get_increment(in);
+            inode->stepa(1) = inca;
+            inode->stepa(2) = incb;
+            inode->stepb(0) = dimsc.get_increment(i);
+        }
+
+        const double *pn = cn.req_const_dataptr();
+        const double *pa = ca.req_const_dataptr();
+        const double *pb = cb.req_const_dataptr();
+        double *pc = cc.req_dataptr();
+
+        if(zero) {
+            tod_div_dirsum<N, M>::start_timer("zero");
+            size_t szc = dimsc.get_size();
+            for(size_t i = 0; i < szc; i++) pc[i] = 0.0;
+            tod_div_dirsum<N, M>::stop_timer("zero");
+        }
+
+        loop_registers<3, 1> r;
+        r.m_ptra[0] = pn;
+        r.m_ptra[1] = pa;
+        r.m_ptra[2] = pb;
+        r.m_ptrb[0] = pc;
+        r.m_ptra_end[0] = pn + dimsn.get_size();
+        r.m_ptra_end[1] = pa + dimsa.get_size();
+        r.m_ptra_end[2] = pb + dimsb.get_size();
+        r.m_ptrb_end[0] = pc + dimsc.get_size();
+
+        {
+            std::auto_ptr< kernel_base<linalg, 3, 1> > kern(
+                kern_ddivsum2::match(m_ka, m_kb,
+                    m_trc.get_scalar_tr().get_coeff(), loop_in, loop_out));
+            tod_div_dirsum<N, M>::start_timer(kern->get_name());
+            loop_list_runner<linalg, 3, 1>(loop_in).run(0, r, *kern);
+            tod_div_dirsum<N, M>::stop_timer(kern->get_name());
+        }
+
+        cn.ret_const_dataptr(pn); pn = 0;
+        ca.ret_const_dataptr(pa); pa = 0;
+        cb.ret_const_dataptr(pb); pb = 0;
+        cc.ret_dataptr(pc); pc = 0;
+
+    } catch(...) {
+        tod_div_dirsum<N, M>::stop_timer();
+        throw;
+    }
+
+    tod_div_dirsum<N, M>::stop_timer();
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_TOD_DIV_DIRSUM_IMPL_H
@@ -17,6 +17,7 @@
 #include "tod_copy.h"
 #include "tod_diag.h"
 #include "tod_dirsum.h"
+#include "tod_div_dirsum.h"
 #include "tod_dotprod.h"
 #include "tod_ewmult2.h"
 #include "tod_extract.h"
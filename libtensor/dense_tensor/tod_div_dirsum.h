@@ -0,0 +1,87 @@
+#ifndef LIBTENSOR_TOD_DIV_DIRSUM_H
+#define LIBTENSOR_TOD_DIV_DIRSUM_H
+
+#include <libtensor/timings.h>
+#include <libtensor/core/noncopyable.h>
+#include <libtensor/core/scalar_transf_double.h>
+#include <libtensor/core/tensor_transf.h>
+#include "dense_tensor_i.h"
+
+namespace libtensor {
+
+
+/** \brief Divides a tensor by the direct sum of two tensors
+    \tparam N Order of the first term of the direct sum.
+    \tparam M Order of the second term of the direct sum.
+
+    Given a tensor \f$ n_{ij\cdots mn\cdots} \f$ and two tensors
+    \f$ a_{ij\cdots} \f$ and \f$ b_{mn\cdots} \f$, the operation computes
+    \f[
+        c_{ij\cdots mn\cdots} = \frac{n_{ij\cdots mn\cdots}}
+            {k_a a_{ij\cdots} + k_b b_{mn\cdots}}
+    \f]
+    The denominator is computed element by element, the direct sum is
+    never stored.
+
+    The order of indexes in the direct sum can be specified using
+    a permutation. The tensor transformation of the result is applied to
+    the quotient.
+
+    \ingroup libtensor_dense_tensor_tod
+ **/
+template<size_t N, size_t M>
+class tod_div_dirsum :
+    public timings< tod_div_dirsum<N, M> >, public noncopyable {
+public:
+    static const char *k_clazz; //!< Class name
+
+public:
+    enum {
+        k_ordera = N, //!< Order of first term (A)
+        k_orderb = M, //!< Order of second term (B)
+        k_orderc = N + M //!< Order of numerator and result (C)
+    };
+
+    typedef tensor_transf<k_orderc, double> tensor_transf_type;
+
+private:
+    dense_tensor_rd_i<k_orderc, double> &m_tn; //!< Numerator
+    dense_tensor_rd_i<k_ordera, double> &m_ta; //!< First term (A)
+    dense_tensor_rd_i<k_orderb, double> &m_tb; //!< Second term (B)
+    double m_ka; //!< Scaling coefficient of A
+    double m_kb; //!< Scaling coefficient of B
+    permutation<k_orderc> m_perms; //!< Permutation of direct sum
+    tensor_transf_type m_trc; //!< Transformation of result
+    dimensions<k_orderc> m_dimsc; //!< Dimensions of the result
+
+public:
+    /** \brief Initializes the operation
+        \param tn Numerator
+        \param ta First term of the denominator
+        \param ka Scalar transformation applied to ta
+        \param tb Second term of the denominator
+        \param kb Scalar transformation applied to tb
+        \param perms Permutation of the direct sum
+        \param trc Tensor transformation applied to result
+     **/
+    tod_div_dirsum(
+            dense_tensor_rd_i<k_orderc, double> &tn,
+            dense_tensor_rd_i<k_ordera, double> &ta,
+            const scalar_transf<double> &ka,
+            dense_tensor_rd_i<k_orderb, double> &tb,
+            const scalar_transf<double> &kb,
+            const permutation<k_orderc> &perms,
+            const tensor_transf_type &trc = tensor_transf_type());
+
+    /** \brief Performs the operation
+        \param zero Zero the output array before running the operation.
+        \param tc Output tensor.
+     **/
+    void perform(bool zero, dense_tensor_wr_i<k_orderc, double> &tc);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_TOD_DIV_DIRSUM_H
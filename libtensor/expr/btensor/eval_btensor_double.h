@@ -10,6 +10,22 @@ namespace expr {
 
 /** \brief Processor of evaluation plan for btensor result type (double)
 
+    Assignments that do not depend on each other, such as the intermediates
+    of several terms of a sum, are evaluated concurrently in the thread pool
+    (see set_concurrency()). The tensors of the expression are modified only
+    once all the assignments started together are done.
+
+    Each intermediate is freed right after the last assignment that uses it,
+    so its memory can be reused by the intermediates computed later.
+    get_interm_stats() reports how much memory the intermediates of the last
+    expression took at most.
+
+    A compiled expression (see compile()) keeps its evaluation tree,
+    intermediates and block tensor operations, including their schedules,
+    from one execution to the next. The operation of an assignment is only
+    set up again when the block structure or symmetry of a tensor it reads
+    has changed.
+
     \ingroup libtensor_expr_btensor
  **/
 template<>
@@ -19,6 +35,16 @@ public:
         Nmax = 8
     };
 
+    /** \brief Statistics of the intermediates of an expression
+     **/
+    struct interm_stats {
+        size_t ninterm; //!< Number of intermediates
+        size_t nbytes; //!< Memory of live intermediates (bytes)
+        size_t nbytes_peak; //!< Peak memory of live intermediates (bytes)
+
+        interm_stats() : ninterm(0), nbytes(0), nbytes_peak(0) { }
+    };
+
 public:
     /** \brief Virtual destructor
      **/
@@ -32,11 +58,29 @@ public:
      **/
     virtual void evaluate(const expr_tree &tree) const;
 
+    /** \brief Compiles an expression tree into a plan
+     **/
+    virtual eval_plan_i *compile(const expr_tree &tree) const;
+
 public:
     /** \brief Specifies whether to use libxm contractions (if available)
      **/
     static void use_libxm(bool usexm);
 
+    /** \brief Limits the concurrent evaluation of independent assignments
+        \param nmax Max number of assignments evaluated at once (1 to
+            evaluate them one after the other, default 4).
+        \param budget Growth of memory in use in bytes, after which no more
+            assignments are started concurrently (0 for a quarter of
+            the memory limit of the allocator, default).
+     **/
+    static void set_concurrency(size_t nmax, size_t budget = 0);
+
+    /** \brief Returns the statistics of the intermediates of the last
+            evaluated expression
+     **/
+    static interm_stats get_interm_stats();
+
 };
 
 
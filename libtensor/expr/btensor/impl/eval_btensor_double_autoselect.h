@@ -43,6 +43,11 @@ public:
      **/
     void evaluate(node_id_t lhs, bool add);
 
+    /** \brief Evaluates the result into given node of another tree (of
+            the same structure)
+     **/
+    void evaluate(const expr_tree &tree, node_id_t lhs, bool add);
+
 };
 
 
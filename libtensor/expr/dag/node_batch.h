@@ -0,0 +1,48 @@
+#ifndef LIBTENSOR_EXPR_NODE_BATCH_H
+#define LIBTENSOR_EXPR_NODE_BATCH_H
+
+#include "node.h"
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Tensor expression node: batch of statements
+
+    A batch groups several assignments (node_assign) or scalings
+    (node_scale), which are its arguments. The statements are evaluated
+    in the order of the arguments as one expression, so subexpressions
+    they have in common can be computed once.
+
+    \sa node, node_assign, node_scale
+
+    \ingroup libtensor_expr_dag
+ **/
+class node_batch : public node {
+public:
+    static const char k_op_type[]; //!< Operation type
+
+public:
+    /** \brief Creates a batch node
+     **/
+    node_batch() :
+        node(k_op_type, 0)
+    { }
+
+    /** \brief Virtual destructor
+     **/
+    virtual ~node_batch() { }
+
+    /** \brief Creates a copy of the node via new
+     **/
+    virtual node *clone() const {
+        return new node_batch(*this);
+    }
+
+};
+
+
+} // namespace expr
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_NODE_BATCH_H
@@ -27,6 +27,11 @@ public:
      **/
     void evaluate(const expr_tree &e) const;
 
+    /** \brief Compiles the given expression with a default evaluator selector
+        into a plan owned by the caller
+     **/
+    eval_plan_i *compile(const expr_tree &e) const;
+
 };
 
 
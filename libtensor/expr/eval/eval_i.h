@@ -2,6 +2,7 @@
 #define LIBTENSOR_EXPR_EVAL_I_H
 
 #include <libtensor/expr/dag/expr_tree.h>
+#include "eval_plan_i.h"
 
 namespace libtensor {
 namespace expr {
@@ -25,9 +26,45 @@ public:
      **/
     virtual void evaluate(const expr::expr_tree &e) const = 0;
 
+    /** \brief Compiles the given expression into a plan
+
+        The default plan evaluates the expression anew on each execution.
+        The plan is owned by the caller.
+     **/
+    virtual eval_plan_i *compile(const expr::expr_tree &e) const;
+
 };
 
 
+/** \brief Plan that evaluates a copy of the expression on each execution
+
+    \ingroup libtensor_expr_eval
+ **/
+class eval_plan_simple : public eval_plan_i {
+private:
+    const eval_i &m_eval; //!< Evaluator
+    expr::expr_tree m_tree; //!< Expression
+
+public:
+    eval_plan_simple(const eval_i &eval, const expr::expr_tree &e) :
+        m_eval(eval), m_tree(e)
+    { }
+
+    virtual ~eval_plan_simple() { }
+
+    virtual void execute() {
+        m_eval.evaluate(m_tree);
+    }
+
+};
+
+
+inline eval_plan_i *eval_i::compile(const expr::expr_tree &e) const {
+
+    return new eval_plan_simple(*this, e);
+}
+
+
 } // namespace expr
 } // namespace libtensor
 
@@ -0,0 +1,32 @@
+#ifndef LIBTENSOR_EXPR_EVAL_PLAN_I_H
+#define LIBTENSOR_EXPR_EVAL_PLAN_I_H
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Compiled expression that can be evaluated repeatedly
+
+    A plan is obtained from an evaluator (see eval_i::compile()). It refers
+    to the tensors of the expression, so each execution uses their current
+    contents.
+
+    \ingroup libtensor_expr_eval
+ **/
+class eval_plan_i {
+public:
+    /** \brief Virtual destructor
+     **/
+    virtual ~eval_plan_i() { }
+
+    /** \brief Evaluates the compiled expression
+     **/
+    virtual void execute() = 0;
+
+};
+
+
+} // namespace expr
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_EVAL_PLAN_I_H
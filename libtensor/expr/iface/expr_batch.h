@@ -0,0 +1,147 @@
+#ifndef LIBTENSOR_EXPR_EXPR_BATCH_H
+#define LIBTENSOR_EXPR_EXPR_BATCH_H
+
+#include <vector>
+#include <libtensor/core/scalar_transf_double.h>
+#include <libtensor/expr/dag/expr_tree.h>
+#include <libtensor/expr/dag/node_assign.h>
+#include <libtensor/expr/dag/node_batch.h>
+#include <libtensor/expr/dag/node_transform.h>
+#include <libtensor/expr/eval/eval.h>
+#include "any_tensor.h"
+#include "expr_rhs.h"
+#include "node_ident_any_tensor.h"
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Batch of tensor assignments evaluated together
+
+    Assignments added to the batch are not evaluated until evaluate() is
+    called. The batch is then evaluated as one expression in the order
+    the assignments were added, which lets subexpressions the assignments
+    have in common be computed only once.
+
+    \code
+    expr_batch b;
+    b.assign(t1, i|j, contract(k, a(i|k), b(k|j)));
+    b.assign_add(t2, j|i, 2.0 * contract(k, a(i|k), b(k|j)));
+    b.evaluate();
+    \endcode
+
+    \ingroup libtensor_expr_iface
+ **/
+class expr_batch {
+private:
+    std::vector<expr_tree*> m_stat; //!< Statements
+
+public:
+    /** \brief Creates an empty batch
+     **/
+    expr_batch() { }
+
+    /** \brief Destructor
+     **/
+    ~expr_batch() {
+        clear();
+    }
+
+    /** \brief Adds the assignment of an expression to a tensor
+     **/
+    template<size_t N, typename T>
+    void assign(any_tensor<N, T> &t, const label<N> &l,
+        const expr_rhs<N, T> &rhs) {
+
+        add(t, l, rhs, false);
+    }
+
+    /** \brief Adds the assignment with addition of an expression to a tensor
+     **/
+    template<size_t N, typename T>
+    void assign_add(any_tensor<N, T> &t, const label<N> &l,
+        const expr_rhs<N, T> &rhs) {
+
+        add(t, l, rhs, true);
+    }
+
+    /** \brief Returns the number of assignments in the batch
+     **/
+    size_t get_size() const {
+        return m_stat.size();
+    }
+
+    /** \brief Evaluates all assignments and empties the batch
+     **/
+    void evaluate() {
+
+        if(m_stat.empty()) return;
+
+        node_batch n;
+        expr_tree e(n);
+        build(e);
+        clear();
+        eval().evaluate(e);
+    }
+
+    /** \brief Compiles all assignments into a plan owned by the caller
+            (null if the batch is empty), the batch keeps the assignments
+     **/
+    eval_plan_i *compile() const {
+
+        if(m_stat.empty()) return 0;
+
+        node_batch n;
+        expr_tree e(n);
+        build(e);
+        return eval().compile(e);
+    }
+
+    /** \brief Removes all assignments without evaluating them
+     **/
+    void clear() {
+        for(size_t i = 0; i < m_stat.size(); i++) delete m_stat[i];
+        m_stat.clear();
+    }
+
+private:
+    void build(expr_tree &e) const {
+        for(size_t i = 0; i < m_stat.size(); i++) {
+            e.add(e.get_root(), *m_stat[i]);
+        }
+    }
+
+    template<size_t N, typename T>
+    void add(any_tensor<N, T> &t, const label<N> &l,
+        const expr_rhs<N, T> &rhs, bool add) {
+
+        expr_tree *e = new expr_tree(node_assign(N, add));
+        expr_tree::node_id_t id = e->get_root();
+        e->add(id, node_ident_any_tensor<N, T>(t));
+
+        permutation<N> px = l.permutation_of(rhs.get_label());
+        if(!px.is_identity()) {
+            std::vector<size_t> perm(N);
+            for(size_t i = 0; i < N; i++) perm[i] = px[i];
+            id = e->add(id, node_transform<T>(perm, scalar_transf<T>()));
+        }
+        e->add(id, rhs.get_expr());
+        m_stat.push_back(e);
+    }
+
+private:
+    expr_batch(const expr_batch&);
+    const expr_batch &operator=(const expr_batch&);
+
+};
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+namespace libtensor {
+using expr::expr_batch;
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_EXPR_BATCH_H
@@ -0,0 +1,112 @@
+#ifndef LIBTENSOR_EXPR_EXPR_PLAN_H
+#define LIBTENSOR_EXPR_EXPR_PLAN_H
+
+#include <libtensor/expr/eval/eval_plan_i.h>
+#include "expr_batch.h"
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Tensor assignments compiled once and evaluated repeatedly
+
+    The assignments are compiled on the first call to execute(), later calls
+    evaluate them again with the current contents of the tensors, which are
+    bound by reference. The work of setting up the evaluation, such as
+    optimizing the expression and the scheduling of the block tensor
+    operations, is thus not repeated (see eval_btensor<double>).
+
+    \code
+    expr_plan p;
+    p.assign(t3, i|j, contract(k, t1(i|k), t2(k|j)));
+    for(size_t iter = 0; iter < niter; iter++) {
+        update(t1);
+        p.execute();
+    }
+    \endcode
+
+    Adding an assignment after the plan has been compiled causes all
+    assignments to be compiled again on the next execution.
+
+    \ingroup libtensor_expr_iface
+ **/
+class expr_plan {
+private:
+    expr_batch m_batch; //!< Assignments
+    eval_plan_i *m_plan; //!< Compiled plan
+
+public:
+    /** \brief Creates an empty plan
+     **/
+    expr_plan() : m_plan(0) { }
+
+    /** \brief Destructor
+     **/
+    ~expr_plan() {
+        clear();
+    }
+
+    /** \brief Adds the assignment of an expression to a tensor
+     **/
+    template<size_t N, typename T>
+    void assign(any_tensor<N, T> &t, const label<N> &l,
+        const expr_rhs<N, T> &rhs) {
+
+        invalidate();
+        m_batch.assign(t, l, rhs);
+    }
+
+    /** \brief Adds the assignment with addition of an expression to a tensor
+     **/
+    template<size_t N, typename T>
+    void assign_add(any_tensor<N, T> &t, const label<N> &l,
+        const expr_rhs<N, T> &rhs) {
+
+        invalidate();
+        m_batch.assign_add(t, l, rhs);
+    }
+
+    /** \brief Returns true if the plan has been compiled
+     **/
+    bool is_compiled() const {
+        return m_plan != 0;
+    }
+
+    /** \brief Evaluates all assignments, compiling them first if needed
+     **/
+    void execute() {
+
+        if(m_plan == 0) m_plan = m_batch.compile();
+        if(m_plan != 0) m_plan->execute();
+    }
+
+    /** \brief Removes all assignments
+     **/
+    void clear() {
+        delete m_plan;
+        m_plan = 0;
+        m_batch.clear();
+    }
+
+private:
+    void invalidate() {
+        delete m_plan;
+        m_plan = 0;
+    }
+
+private:
+    expr_plan(const expr_plan&);
+    const expr_plan &operator=(const expr_plan&);
+
+};
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+namespace libtensor {
+using expr::expr_plan;
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_EXPR_PLAN_H
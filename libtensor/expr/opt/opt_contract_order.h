@@ -0,0 +1,91 @@
+#ifndef LIBTENSOR_EXPR_OPT_CONTRACT_ORDER_H
+#define LIBTENSOR_EXPR_OPT_CONTRACT_ORDER_H
+
+#include <vector>
+#include <libtensor/expr/dag/graph.h>
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Provides the sizes of tensors to opt_contract_order()
+
+    \ingroup libtensor_expr_opt
+ **/
+class contract_cost_i {
+public:
+    /** \brief Virtual destructor
+     **/
+    virtual ~contract_cost_i() { }
+
+    /** \brief Returns the dimensions of the result of a node and the
+            fraction of its elements that are non-zero
+        \param g Expression graph.
+        \param id Node ID.
+        \param[out] dims Dimensions (one per index of the node).
+        \param[out] density Fraction of non-zero elements (0 to 1).
+        \return True if the sizes are known, false otherwise.
+     **/
+    virtual bool get_dims(const graph &g, graph::node_id_t id,
+        std::vector<size_t> &dims, double &density) const = 0;
+
+};
+
+
+/** \brief Estimates the dimensions and the fraction of non-zero elements
+        of the result of a node
+
+    The sizes are provided by the cost object or derived from the arguments
+    of transformations, contractions, additions and the like. Indexes whose
+    size cannot be worked out are taken to be ten long, and their tensors
+    dense.
+
+    \ingroup libtensor_expr_opt
+ **/
+void estimate_dims(const graph &g, graph::node_id_t id,
+    const contract_cost_i &cost, std::vector<size_t> &dims, double &density);
+
+
+/** \brief Chooses the order of pairwise contractions in contractions of
+        three or more tensors
+
+    This optimizer first merges contractions that are arguments of other
+    contractions into one contraction node:
+    ( C ( C E1 E2 ) E3 ) --> ( C E1 E2 E3 )
+    Contractions that are used more than once are not merged, neither are
+    contractions of a tensor with itself, whose result has the symmetry
+    under the exchange of the two factors.
+
+    Each contraction of three or more tensors is then replaced by a tree of
+    pairwise contractions with the least estimated cost, which is
+    the number of floating-point operations plus the size of
+    the intermediates. The estimate takes the dimensions and the fraction of
+    non-zero elements of the arguments from the cost object; arguments it
+    does not know are taken as dense, with all dimensions equal. All orders
+    are tried for up to five tensors, up to twelve tensors are ordered by
+    dynamic programming over subsets, and larger contractions are ordered
+    greedily.
+
+    Intermediates put the indexes contracted in the next step last.
+    The result keeps the order of indexes of the original contraction.
+    Where a pairwise contraction yields its indexes in another order,
+    a transformation node is inserted.
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_contract_order(graph &g, const contract_cost_i &cost);
+
+
+/** \brief Chooses the order of pairwise contractions assuming that all
+        tensors are dense and all dimensions are equal
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_contract_order(graph &g);
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+#endif // LIBTENSOR_EXPR_OPT_CONTRACT_ORDER_H
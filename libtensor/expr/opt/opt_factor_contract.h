@@ -0,0 +1,40 @@
+#ifndef LIBTENSOR_EXPR_OPT_FACTOR_CONTRACT_H
+#define LIBTENSOR_EXPR_OPT_FACTOR_CONTRACT_H
+
+#include <libtensor/expr/dag/graph.h>
+#include "opt_contract_order.h"
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Takes common factors out of sums of contractions
+
+    This optimizer looks for terms of additions that contract the same
+    argument in the same way with different tensors and replaces them by
+    one contraction with the sum of the other arguments:
+    ( + ( C E1 E2 ) ( C E1 E3 ) E4 ) --> ( + ( C E1 ( + E2 E3 ) ) E4 )
+    The common argument has to be the same node in the same position of
+    each contraction, with the same permutation of indexes; the terms have
+    to contract the same indexes and may only differ in their coefficients,
+    which are moved to the arguments of the new addition.
+
+    The sum of the other arguments becomes an intermediate, so the terms are
+    only factored if the estimated number of floating-point operations saved
+    in the contractions exceeds the cost of computing and storing the sum.
+    The estimate takes the dimensions and the fraction of non-zero elements
+    of the arguments from the cost object.
+
+    Terms and contractions shared with other nodes are left as they are.
+    The factored contraction takes the place of the first of its terms.
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_factor_contract(graph &g, const contract_cost_i &cost);
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+#endif // LIBTENSOR_EXPR_OPT_FACTOR_CONTRACT_H
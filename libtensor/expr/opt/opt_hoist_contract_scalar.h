@@ -0,0 +1,37 @@
+#ifndef LIBTENSOR_EXPR_OPT_HOIST_CONTRACT_SCALAR_H
+#define LIBTENSOR_EXPR_OPT_HOIST_CONTRACT_SCALAR_H
+
+#include <libtensor/expr/dag/graph.h>
+#include "opt_contract_order.h"
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Moves the scaling coefficients of the arguments of contractions
+        to the smallest argument
+
+    This optimizer collects the coefficients of the transformations of
+    the arguments of each contraction into one coefficient, which is put on
+    the argument with the fewest non-zero elements according to the cost
+    object:
+    ( C ( Tr E1 a ) ( Tr E2 b ) ) --> ( C E1 ( Tr E2 ab ) )
+    Transformations left with neither a permutation nor a coefficient are
+    removed. Contractions whose scaled arguments are shared with other
+    nodes are left as they are.
+
+    Block contractions apply the coefficients for free, so the point is
+    a canonical form: contractions of the same arguments that differ only in
+    where the coefficients are become identical and can be merged by
+    opt_merge_equiv_subexpr().
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_hoist_contract_scalar(graph &g, const contract_cost_i &cost);
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+#endif // LIBTENSOR_EXPR_OPT_HOIST_CONTRACT_SCALAR_H
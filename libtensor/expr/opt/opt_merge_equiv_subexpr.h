@@ -0,0 +1,40 @@
+#ifndef LIBTENSOR_EXPR_OPT_MERGE_EQUIV_SUBEXPR_H
+#define LIBTENSOR_EXPR_OPT_MERGE_EQUIV_SUBEXPR_H
+
+#include <libtensor/expr/dag/graph.h>
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Merges equivalent subexpressions
+
+    This optimizer replaces any duplicates of a subexpression with one node
+    that is shared by all users of the subexpression. Subexpressions are
+    compared bottom-up by a signature made of the operation, its parameters
+    and the (already merged) arguments. The arguments of additions are
+    compared as a set. A contraction of two tensors also matches
+    the contraction with the arguments swapped; in that case the duplicate
+    is replaced by a permutation of the shared node:
+    ( C E2 E1 ) --> ( Tr ( C E1 E2 ) )
+
+    Tensor identities are left to opt_merge_equiv_ident(). Assignments and
+    scalings are never merged. If the graph contains more than one
+    statement, subexpressions that read a tensor assigned by any of
+    the statements are not merged either, so each statement sees the values
+    written by the statements before it.
+
+    Transformations remain private to their users: a transformation node
+    that ends up with several users is copied, so it is the underlying
+    operation that is shared.
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_merge_equiv_subexpr(graph &g);
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+#endif // LIBTENSOR_EXPR_OPT_MERGE_EQUIV_SUBEXPR_H
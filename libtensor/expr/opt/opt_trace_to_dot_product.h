@@ -0,0 +1,34 @@
+#ifndef LIBTENSOR_EXPR_OPT_TRACE_TO_DOT_PRODUCT_H
+#define LIBTENSOR_EXPR_OPT_TRACE_TO_DOT_PRODUCT_H
+
+#include <libtensor/expr/dag/graph.h>
+
+namespace libtensor {
+namespace expr {
+
+
+/** \brief Turns traces of contractions into dot products
+
+    This optimizer replaces the trace of a pairwise contraction, in which
+    every index of one argument ends up summed with an index of the other,
+    by the dot product of the arguments:
+    ( Trace ( C E1 E2 ) ) --> ( Dot E1 E2 )
+    so the product of the arguments is never formed. Any coefficient of
+    the contraction is moved to the first argument. Contractions shared with
+    other nodes are left as they are.
+
+    The arguments of dot products are then swapped where the second one is
+    a tensor and the first one is not. The second argument of a dot product
+    is computed block by block as the dot product is taken, without forming
+    an intermediate.
+
+    \ingroup libtensor_expr_opt
+ **/
+void opt_trace_to_dot_product(graph &g);
+
+
+} // namespace expr
+} // namespace libtensor
+
+
+#endif // LIBTENSOR_EXPR_OPT_TRACE_TO_DOT_PRODUCT_H
@@ -1,6 +1,8 @@
 #ifndef LIBTENSOR_DIRECT_GEN_BLOCK_TENSOR_H
 #define LIBTENSOR_DIRECT_GEN_BLOCK_TENSOR_H
 
+#include <map>
+#include <set>
 #include <libutil/threads/mutex.h>
 #include <libutil/threads/cond_map.h>
 #include "block_map.h"
@@ -9,10 +11,47 @@
 namespace libtensor {
 
 
+/** \brief Statistics of the block cache of a direct block tensor
+
+    \ingroup libtensor_gen_block_tensor
+ **/
+struct direct_gen_block_cache_stats {
+    size_t nhits; //!< Number of requests served without computation
+    size_t nmisses; //!< Number of requests that computed the block
+    size_t nevict; //!< Number of blocks evicted from the cache
+    size_t cur_bytes; //!< Current size of all resident blocks
+    size_t max_bytes; //!< Peak size of all resident blocks
+    double compute_time; //!< Total wall time spent computing blocks (s)
+
+    direct_gen_block_cache_stats() :
+        nhits(0), nmisses(0), nevict(0), cur_bytes(0), max_bytes(0),
+        compute_time(0.0)
+    { }
+
+    /** \brief Returns the fraction of requests served from memory
+     **/
+    double hit_rate() const {
+        size_t nreq = nhits + nmisses;
+        return nreq == 0 ? 0.0 : double(nhits) / double(nreq);
+    }
+};
+
+
 /** \brief Direct generalized block tensor
     \tparam N Tensor order.
     \tparam BtTraits Block tensor traits.
 
+    Blocks are computed on request using the underlying operation. By default
+    a block is released as soon as the last reference to it is returned.
+
+    With a non-zero cache limit, blocks that are no longer referenced are kept
+    in memory for later requests as long as the total size of all resident
+    blocks does not exceed the limit. When memory is needed, unreferenced
+    blocks are evicted in the least-recently-used order. In the cost-aware
+    mode, the eviction order also accounts for the time it took to compute
+    each block per byte of storage (GreedyDual-Size), so blocks that are cheap
+    to recompute are evicted first.
+
     \ingroup libtensor_gen_block_tensor
  **/
 template<size_t N, typename BtTraits>
@@ -41,6 +80,16 @@ public:
     //! Type of block %tensor operation
     typedef typename base_t::operation_t operation_t;
 
+private:
+    //! Eviction priority of a block and the sequence number to break ties
+    typedef std::pair<double, size_t> cache_key_t;
+
+    struct cache_entry {
+        size_t sz; //!< Size of the block in bytes
+        double cost; //!< Time to compute the block per byte
+        cache_key_t key; //!< Position in the eviction queue
+    };
+
 private:
     dimensions<N> m_bidims; //!< Block %index dims
     libutil::mutex m_lock; //!< Mutex lock
@@ -48,18 +97,61 @@ private:
     std::map<size_t, size_t> m_count; //!< Block count
     std::set<size_t> m_inprogress; //!< Computations in progress
     libutil::cond_map<size_t, size_t> m_cond; //!< Conditionals
+    size_t m_cache_limit; //!< Max size of resident blocks in bytes
+    bool m_cost_aware; //!< Cost-aware eviction
+    std::map<size_t, cache_entry> m_entries; //!< Resident blocks
+    std::map<cache_key_t, size_t> m_evictq; //!< Unreferenced blocks
+    double m_clock; //!< Aging clock of the eviction queue
+    size_t m_seq; //!< Sequence number of the last enqueued block
+    direct_gen_block_cache_stats m_stats; //!< Cache statistics
 
 public:
     //!    \name Construction and destruction
     //@{
 
-    direct_gen_block_tensor(operation_t &op);
+    /** \brief Initializes the direct block tensor
+        \param op Underlying operation.
+        \param cache_limit Max size of cached blocks in bytes (0 - no cache).
+        \param cost_aware Account for the compute time in eviction decisions.
+     **/
+    direct_gen_block_tensor(operation_t &op, size_t cache_limit = 0,
+        bool cost_aware = false);
+
     virtual ~direct_gen_block_tensor() { }
 
     //@}
 
     using direct_gen_block_tensor_base<N, bti_traits>::get_bis;
 
+    //!    \name Block cache
+    //@{
+
+    /** \brief Changes the memory limit of the block cache, evicts blocks
+            if necessary
+        \param cache_limit Max size of cached blocks in bytes (0 - no cache).
+     **/
+    void set_cache_limit(size_t cache_limit);
+
+    /** \brief Returns the memory limit of the block cache
+     **/
+    size_t get_cache_limit() const {
+        return m_cache_limit;
+    }
+
+    /** \brief Removes all unreferenced blocks from the cache
+     **/
+    void clear_cache();
+
+    /** \brief Returns the cache statistics
+     **/
+    direct_gen_block_cache_stats get_cache_stats();
+
+    /** \brief Resets the hit, miss, eviction and timing counters
+     **/
+    void reset_cache_stats();
+
+    //@}
+
 protected:
     //!    \name Implementation of libtensor::gen_block_tensor_rd_i<N, bti_traits>
     //@{
@@ -79,6 +171,15 @@ protected:
 private:
     //! \brief Performs calculation of the given block
     void perform(const index<N>& idx);
+
+    /** \brief Inserts an unreferenced block into the eviction queue
+     **/
+    void enqueue(size_t aidx, cache_entry &e);
+
+    /** \brief Evicts unreferenced blocks until the resident blocks fit
+            in the given size
+     **/
+    void evict(size_t limit);
 };
 
 
@@ -1,6 +1,7 @@
 #ifndef LIBTENSOR_DIRECT_GEN_BTO_H
 #define LIBTENSOR_DIRECT_GEN_BTO_H
 
+#include <libutil/thread_pool/thread_pool.h>
 #include <libtensor/core/block_index_space.h>
 #include <libtensor/core/symmetry.h>
 #include "assignment_schedule.h"
@@ -20,6 +21,22 @@ namespace libtensor {
  **/
 template<size_t N, typename BtiTraits>
 class direct_gen_bto {
+private:
+    /** \brief Task that runs the operation
+     **/
+    class perform_task : public libutil::task_i {
+    private:
+        direct_gen_bto<N, BtiTraits> &m_op; //!< Operation
+        gen_block_stream_i<N, BtiTraits> &m_out; //!< Output stream
+
+    public:
+        perform_task(direct_gen_bto<N, BtiTraits> &op,
+            gen_block_stream_i<N, BtiTraits> &out) : m_op(op), m_out(out) { }
+        virtual ~perform_task() { }
+        virtual unsigned long get_cost() const { return 0; }
+        virtual void perform() { m_op.perform(m_out); }
+    };
+
 public:
     //! Type of tensor elements
     typedef typename BtiTraits::element_type element_type;
@@ -47,6 +64,22 @@ public:
      **/
     virtual void perform(gen_block_stream_i<N, BtiTraits> &out) = 0;
 
+    /** \brief Starts the operation in the thread pool and returns
+            immediately, the result is written into the output stream
+        \param out Output stream.
+        \param f Future to wait on for the completion of the operation.
+        \param priority Priority hint for the thread pool.
+
+        The operation and the output stream must exist until f.wait()
+        returns. Exceptions are rethrown by f.wait().
+     **/
+    void perform_async(gen_block_stream_i<N, BtiTraits> &out,
+        libutil::task_future &f, int priority = 0) {
+
+        libutil::thread_pool::submit_async(new perform_task(*this, out), f,
+            priority);
+    }
+
     /** \brief Computes one block
         \param idx Index of block to compute.
         \param blk Tensor block to write result to.
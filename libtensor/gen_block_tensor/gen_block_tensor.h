@@ -1,6 +1,7 @@
 #ifndef LIBTENSOR_GEN_BLOCK_TENSOR_H
 #define LIBTENSOR_GEN_BLOCK_TENSOR_H
 
+#include <string>
 #include <libutil/threads/mutex.h>
 #include <libtensor/core/block_index_space.h>
 #include <libtensor/core/immutable.h>
@@ -87,6 +88,7 @@ public:
     symmetry<N, element_type> m_symmetry; //!< Block tensor symmetry
     block_map<N, BtTraits> m_map; //!< Block map
     libutil::mutex m_lock; //!< Read-write lock
+    std::string m_name; //!< Name for memory accounting
 
 public:
     //!    \name Construction and destruction
@@ -100,6 +102,19 @@ public:
     virtual const block_index_space<N> &get_bis() const;
     //@}
 
+    /** \brief Sets the name under which the memory of new blocks is
+            accounted for (see memory_accounting)
+     **/
+    void set_name(const std::string &name) {
+        m_name = name;
+    }
+
+    /** \brief Returns the name for memory accounting
+     **/
+    const std::string &get_name() const {
+        return m_name;
+    }
+
 protected:
     //!    \name Implementation of libtensor::gen_block_tensor_i<N, bti_traits>
     //@{
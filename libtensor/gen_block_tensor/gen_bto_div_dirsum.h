@@ -0,0 +1,178 @@
+#ifndef LIBTENSOR_GEN_BTO_DIV_DIRSUM_H
+#define LIBTENSOR_GEN_BTO_DIV_DIRSUM_H
+
+#include <libtensor/timings.h>
+#include <libtensor/core/noncopyable.h>
+#include <libtensor/core/tensor_transf.h>
+#include "additive_gen_bto.h"
+#include "assignment_schedule.h"
+#include "gen_block_stream_i.h"
+#include "gen_block_tensor_i.h"
+#include "impl/gen_bto_dirsum_sym.h"
+
+namespace libtensor {
+
+
+/** \brief Divides the result of a block tensor operation by the direct sum
+        of two block tensors
+    \tparam N Order of the first term of the direct sum.
+    \tparam M Order of the second term of the direct sum.
+    \tparam Traits Block tensor operation traits.
+    \tparam Timed Timed implementation.
+
+    Computes
+    \f$ c_{ij\cdots mn\cdots} = n_{ij\cdots mn\cdots} /
+        (\hat{S}_a a_{ij\cdots} + \hat{S}_b b_{mn\cdots}) \f$,
+    where the numerator is the result of an additive block tensor operation
+    and the order of indexes of the direct sum in the denominator is given
+    by a permutation.
+
+    Each block of the numerator is computed as the respective block of
+    the result is computed. The denominator is computed element by element
+    from the blocks of A and B, so neither the numerator nor the direct sum
+    are ever stored as block tensors.
+
+    The traits class has to provide definitions for
+    - \c element_type -- Type of data elements
+    - \c bti_traits -- Type of block tensor interface traits class
+    - \c template temp_block_tensor_type<N>::type -- Type of temporary block
+        tensor
+    - \c template temp_block_type<N>::type -- Type of temporary tensor block
+    - \c template to_copy_type<N>::type -- Type of tensor operation to_copy
+    - \c template to_div_dirsum_type<N, M>::type -- Type of tensor operation
+        to_div_dirsum
+    - \c template to_set_type<N>::type -- Type of tensor operation to_set
+
+    \sa gen_bto_dirsum, gen_bto_mult_direct
+
+    \ingroup libtensor_gen_bto
+ **/
+template<size_t N, size_t M, typename Traits, typename Timed>
+class gen_bto_div_dirsum : public timings<Timed>, public noncopyable {
+public:
+    static const char k_clazz[]; //!< Class name
+
+public:
+    enum {
+        NA = N, //!< Order of first term (A)
+        NB = M, //!< Order of second term (B)
+        NC = N + M //!< Order of numerator and result (C)
+    };
+
+public:
+    //! Type of tensor elements
+    typedef typename Traits::element_type element_type;
+
+    //! Block tensor interface traits
+    typedef typename Traits::bti_traits bti_traits;
+
+    //! Type of read-only block in A
+    typedef typename bti_traits::template rd_block_type<NA>::type
+            rd_block_a_type;
+
+    //! Type of read-only block in B
+    typedef typename bti_traits::template rd_block_type<NB>::type
+            rd_block_b_type;
+
+    //! Type of write-only block
+    typedef typename bti_traits::template wr_block_type<NC>::type wr_block_type;
+
+    //! Type of scalar transformation
+    typedef scalar_transf<element_type> scalar_transf_type;
+
+    //! Type of tensor transformation of result
+    typedef tensor_transf<NC, element_type> tensor_transf_type;
+
+private:
+    additive_gen_bto<NC, bti_traits> &m_opn; //!< Numerator
+    gen_block_tensor_rd_i<NA, bti_traits> &m_bta; //!< First term (A)
+    gen_block_tensor_rd_i<NB, bti_traits> &m_btb; //!< Second term (B)
+    scalar_transf_type m_ka; //!< Coefficient A
+    scalar_transf_type m_kb; //!< Coefficient B
+    permutation<NC> m_perms; //!< Permutation of the direct sum
+    scalar_transf_type m_trc; //!< Scalar transformation of the result
+    gen_bto_dirsum_sym<NA, NB, Traits> m_syms; //!< Symmetry of direct sum
+    block_index_space<NC> m_bisc; //!< Block index space of the result
+    symmetry<NC, element_type> m_symc; //!< Symmetry of the result
+    assignment_schedule<NC, element_type> m_sch; //!< Schedule
+
+public:
+    //! \name Constructors / destructor
+    //@{
+
+    /** \brief Initializes the operation
+        \param opn Numerator
+        \param bta First term of the denominator (A)
+        \param ka Scalar transformation of A
+        \param btb Second term of the denominator (B)
+        \param kb Scalar transformation of B
+        \param perms Permutation of the direct sum
+        \param trc Scalar transformation of the result
+     **/
+    gen_bto_div_dirsum(
+            additive_gen_bto<NC, bti_traits> &opn,
+            gen_block_tensor_rd_i<NA, bti_traits> &bta,
+            const scalar_transf_type &ka,
+            gen_block_tensor_rd_i<NB, bti_traits> &btb,
+            const scalar_transf_type &kb,
+            const permutation<NC> &perms,
+            const scalar_transf_type &trc = scalar_transf_type());
+
+    /** \brief Virtual destructor
+     **/
+    virtual ~gen_bto_div_dirsum() { }
+
+    //@}
+
+    /** \brief Returns the block index space of the result
+     **/
+    const block_index_space<NC> &get_bis() const {
+        return m_bisc;
+    }
+
+    /** \brief Returns the symmetry of the result
+     **/
+    const symmetry<NC, element_type> &get_symmetry() const {
+        return m_symc;
+    }
+
+    /** \brief Returns the list of canonical non-zero blocks of the result
+     **/
+    const assignment_schedule<NC, element_type> &get_schedule() const {
+        return m_sch;
+    }
+
+    /** \brief Computes and writes the blocks of the result to an output stream
+        \param out Output stream.
+     **/
+    void perform(gen_block_stream_i<NC, bti_traits> &out);
+
+    /** \brief Computes one block of the result
+        \param zero Zero target block first
+        \param ic Index of target block
+        \param trc Tensor transformation
+        \param blkc Target block
+     **/
+    void compute_block(
+        bool zero,
+        const index<NC> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc);
+
+    /** \brief Same as compute_block(), except it doesn't run a timer
+     **/
+    void compute_block_untimed(
+        bool zero,
+        const index<NC> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc);
+
+private:
+    void make_schedule();
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_GEN_BTO_DIV_DIRSUM_H
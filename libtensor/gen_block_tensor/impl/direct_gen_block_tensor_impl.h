@@ -3,6 +3,7 @@
 
 #include <libutil/threads/auto_lock.h>
 #include <libutil/thread_pool/thread_pool.h>
+#include <libutil/timings/timer.h>
 #include <libtensor/core/abs_index.h>
 #include "block_map_impl.h"
 
@@ -73,13 +74,59 @@ const char *direct_gen_block_tensor<N, BtTraits>::k_clazz =
 
 
 template<size_t N, typename BtTraits>
-direct_gen_block_tensor<N, BtTraits>::direct_gen_block_tensor(operation_t &op) :
+direct_gen_block_tensor<N, BtTraits>::direct_gen_block_tensor(operation_t &op,
+    size_t cache_limit, bool cost_aware) :
 
-    base_t(op), m_bidims(get_bis().get_block_index_dims()), m_map(get_bis()) {
+    base_t(op), m_bidims(get_bis().get_block_index_dims()), m_map(get_bis()),
+    m_cache_limit(cache_limit), m_cost_aware(cost_aware), m_clock(0.0),
+    m_seq(0) {
 
 }
 
 
+template<size_t N, typename BtTraits>
+void direct_gen_block_tensor<N, BtTraits>::set_cache_limit(
+    size_t cache_limit) {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    m_cache_limit = cache_limit;
+    evict(m_cache_limit);
+}
+
+
+template<size_t N, typename BtTraits>
+void direct_gen_block_tensor<N, BtTraits>::clear_cache() {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    evict(0);
+}
+
+
+template<size_t N, typename BtTraits>
+direct_gen_block_cache_stats
+direct_gen_block_tensor<N, BtTraits>::get_cache_stats() {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    return m_stats;
+}
+
+
+template<size_t N, typename BtTraits>
+void direct_gen_block_tensor<N, BtTraits>::reset_cache_stats() {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    m_stats.nhits = 0;
+    m_stats.nmisses = 0;
+    m_stats.nevict = 0;
+    m_stats.max_bytes = m_stats.cur_bytes;
+    m_stats.compute_time = 0.0;
+}
+
+
 template<size_t N, typename BtTraits>
 bool direct_gen_block_tensor<N, BtTraits>::on_req_is_zero_block(
     const index<N> &idx) {
@@ -124,36 +171,64 @@ direct_gen_block_tensor<N, BtTraits>::on_req_const_block(
 #endif // LIBTENSOR_DEBUG
 
     abs_index<N> aidx(idx, m_bidims);
+    size_t ia = aidx.get_abs_index();
     typename std::map<size_t, size_t>::iterator icnt =
-        m_count.insert(std::make_pair(aidx.get_abs_index(), size_t(0))).first;
-    bool newblock = icnt->second++ == 0;
-    bool inprogress = m_inprogress.count(aidx.get_abs_index()) > 0;
+        m_count.insert(std::make_pair(ia, size_t(0))).first;
+    bool newblock = false;
+    if(icnt->second++ == 0) {
+        typename std::map<size_t, cache_entry>::iterator ie =
+            m_entries.find(ia);
+        if(ie == m_entries.end()) newblock = true;
+        else m_evictq.erase(ie->second.key);
+    }
+    bool inprogress = m_inprogress.count(ia) > 0;
 
     if(newblock) {
+        size_t sz = get_bis().get_block_dims(idx).get_size() *
+            sizeof(element_type);
+        if(m_cache_limit > 0) {
+            evict(m_cache_limit > sz ? m_cache_limit - sz : 0);
+        }
         m_map.create(idx);
+        cache_entry &e = m_entries[ia];
+        e.sz = sz;
+        e.cost = 0.0;
+        m_stats.nmisses++;
+        m_stats.cur_bytes += sz;
+        if(m_stats.cur_bytes > m_stats.max_bytes) {
+            m_stats.max_bytes = m_stats.cur_bytes;
+        }
+    } else {
+        m_stats.nhits++;
     }
 
     block_type &blk = m_map.get(idx);
 
     if(newblock) {
 
-        std::set<size_t>::iterator i =
-                m_inprogress.insert(aidx.get_abs_index()).first;
+        std::set<size_t>::iterator i = m_inprogress.insert(ia).first;
+        libutil::timer tmr;
         m_lock.unlock();
         try {
+            tmr.start();
             get_op().compute_block(idx, blk);
+            tmr.stop();
         } catch(...) {
             m_lock.lock();
             throw;
         }
         m_lock.lock();
+        double t = tmr.duration().wall_time();
+        cache_entry &e = m_entries[ia];
+        e.cost = t / double(e.sz);
+        m_stats.compute_time += t;
         m_inprogress.erase(i);
-        m_cond.signal(aidx.get_abs_index());
+        m_cond.signal(ia);
 
     } else if(inprogress) {
 
         libutil::loaded_cond<size_t> cond(0);
-        m_cond.insert(aidx.get_abs_index(), &cond);
+        m_cond.insert(ia, &cond);
         m_lock.unlock();
         try {
             libutil::thread_pool::release_cpu();
@@ -164,7 +239,7 @@ direct_gen_block_tensor<N, BtTraits>::on_req_const_block(
             throw;
         }
         m_lock.lock();
-        m_cond.erase(aidx.get_abs_index(), &cond);
+        m_cond.erase(ia, &cond);
     }
 
     return blk;
@@ -187,8 +262,54 @@ void direct_gen_block_tensor<N, BtTraits>::on_ret_const_block(
     }
 
     if(--icnt->second == 0) {
-        m_map.remove(idx);
         m_count.erase(icnt);
+        typename std::map<size_t, cache_entry>::iterator ie =
+            m_entries.find(aidx.get_abs_index());
+        if(ie->second.sz <= m_cache_limit) {
+            enqueue(ie->first, ie->second);
+            evict(m_cache_limit);
+        } else {
+            m_stats.cur_bytes -= ie->second.sz;
+            m_entries.erase(ie);
+            m_map.remove(idx);
+        }
+    }
+}
+
+
+template<size_t N, typename BtTraits>
+void direct_gen_block_tensor<N, BtTraits>::enqueue(size_t aidx,
+    cache_entry &e) {
+
+    //  LRU: priority grows with every returned block.
+    //  GreedyDual-Size: priority is the aging clock plus the cost of
+    //  recomputation per byte; the clock advances to the priority of
+    //  the last evicted block.
+
+    m_seq++;
+    double prio = m_cost_aware ? m_clock + e.cost : double(m_seq);
+    e.key = cache_key_t(prio, m_seq);
+    m_evictq.insert(std::make_pair(e.key, aidx));
+}
+
+
+template<size_t N, typename BtTraits>
+void direct_gen_block_tensor<N, BtTraits>::evict(size_t limit) {
+
+    while(m_stats.cur_bytes > limit && !m_evictq.empty()) {
+
+        typename std::map<cache_key_t, size_t>::iterator iq = m_evictq.begin();
+        if(m_cost_aware) m_clock = iq->first.first;
+
+        typename std::map<size_t, cache_entry>::iterator ie =
+            m_entries.find(iq->second);
+        index<N> idx;
+        abs_index<N>::get_index(ie->first, m_bidims, idx);
+        m_stats.cur_bytes -= ie->second.sz;
+        m_stats.nevict++;
+        m_entries.erase(ie);
+        m_evictq.erase(iq);
+        m_map.remove(idx);
     }
 }
 
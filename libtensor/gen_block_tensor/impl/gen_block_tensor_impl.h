@@ -2,6 +2,7 @@
 #define LIBTENSOR_GEN_BLOCK_TENSOR_IMPL_H
 
 #include <libutil/threads/auto_lock.h>
+#include <libtensor/core/memory_accounting.h>
 #include <libtensor/core/short_orbit.h>
 #include "../gen_block_tensor.h"
 
@@ -192,6 +193,7 @@ gen_block_tensor<N, BtTraits>::get_block(const index<N> &idx, bool create) {
 
     if(!m_map.contains(idx)) {
         if(create) {
+            memory_owner owner(m_name.c_str());
             m_map.create(idx);
         } else {
             throw symmetry_violation(g_ns, k_clazz, method, __FILE__, __LINE__,
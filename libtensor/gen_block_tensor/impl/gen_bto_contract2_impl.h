@@ -121,10 +121,13 @@ void gen_bto_contract2<N, M, K, Traits, Timed>::perform(
 
         gen_bto_contract2_batching_policy<N, M, K> bp(m_contr,
             nblka, nblkb, nblkc);
-        size_t batchsza = bp.get_bsz_a(), batchszb = bp.get_bsz_b(),
+        //  Batches of A and B are set up once, batches of C adapt to
+        //  the memory in use before each one
+        size_t batchsza = batching_policy_base::scale(bp.get_bsz_a()),
+            batchszb = batching_policy_base::scale(bp.get_bsz_b()),
             batchszc = bp.get_bsz_c();
 
-        std::list< std::vector<size_t> > batchesa, batchesb, batchesc,
+        std::list< std::vector<size_t> > batchesa, batchesb,
             fbatchesa, fbatchesb;
         typedef typename std::list< std::vector<size_t> >::const_iterator
             batch_iterator;
@@ -181,21 +184,16 @@ void gen_bto_contract2<N, M, K, Traits, Timed>::perform(
             }
         }
 
-        typename assignment_schedule<NC, element_type>::iterator ibc =
-            m_sch.begin();
-        while(ibc != m_sch.end()) {
+        std::vector<size_t> blstc;
+        blstc.reserve(nblkc);
+        for(typename assignment_schedule<NC, element_type>::iterator ibc =
+            m_sch.begin(); ibc != m_sch.end(); ++ibc) {
 
-            batchesc.push_back(std::vector<size_t>());
-            std::vector<size_t> &batchc = batchesc.back();
-            batchc.reserve(batchszc);
-
-            for(; ibc != m_sch.end() && batchc.size() < batchszc; ++ibc) {
-                index<NC> ic;
-                abs_index<NC>::get_index(m_sch.get_abs_index(ibc), bidimsc, ic);
-                ic.permute(permc);
-                short_orbit<NC, element_type> oct(symct, ic);
-                batchc.push_back(oct.get_acindex());
-            }
+            index<NC> ic;
+            abs_index<NC>::get_index(m_sch.get_abs_index(ibc), bidimsc, ic);
+            ic.permute(permc);
+            short_orbit<NC, element_type> oct(symct, ic);
+            blstc.push_back(oct.get_acindex());
         }
 
         gen_bto_prefetch<NA, Traits> prefetch_a(m_bta);
@@ -281,10 +279,12 @@ void gen_bto_contract2<N, M, K, Traits, Timed>::perform(
                     prefetch_b.perform(fbatchesb.front());
                 }
 
-                for(batch_iterator ibc = batchesc.begin();
-                    ibc != batchesc.end(); ++ibc) {
+                for(size_t ibc = 0; ibc < blstc.size();) {
 
-                    const std::vector<size_t> &batchc = *ibc;
+                    size_t bszc = batching_policy_base::scale(batchszc);
+                    std::vector<size_t> batchc(blstc.begin() + ibc,
+                        blstc.begin() + std::min(ibc + bszc, blstc.size()));
+                    ibc += batchc.size();
 
                     tensor_transf<NC, element_type> trc(permcinv);
                     gen_bto_aux_transform<NC, Traits> out2(trc,
@@ -21,6 +21,121 @@
 namespace libtensor {
 
 
+/** \brief Thread-safe set of visited block indexes
+
+    The set is a bitmap over the entire block index space if it is small
+    enough, and a sorted list of indexes otherwise.
+ **/
+class gen_bto_contract2_nzorb_visited {
+public:
+    //! Largest index space represented by a bitmap
+    static const size_t k_max_bitmap = 134217728;
+
+private:
+    libutil::mutex m_mtx; //!< Lock
+    bool m_use_bitmap; //!< Whether the bitmap is used
+    std::vector<bool> m_bitmap; //!< Bitmap of visited indexes
+    std::vector<size_t> m_sorted; //!< Sorted list of visited indexes
+
+public:
+    gen_bto_contract2_nzorb_visited(size_t sz) :
+        m_use_bitmap(sz <= k_max_bitmap) {
+
+        if(m_use_bitmap) m_bitmap.resize(sz, false);
+    }
+
+    /** \brief Removes visited indexes from a sorted list of unique
+            candidates and marks the remaining ones visited
+     **/
+    void visit(std::vector<size_t> &cand) {
+
+        libutil::auto_lock<libutil::mutex> lock(m_mtx);
+
+        if(m_use_bitmap) {
+            size_t j = 0;
+            for(size_t i = 0; i < cand.size(); i++) {
+                if(m_bitmap[cand[i]]) continue;
+                m_bitmap[cand[i]] = true;
+                cand[j++] = cand[i];
+            }
+            cand.resize(j);
+            return;
+        }
+
+        std::vector<size_t> tmp;
+        std::vector<size_t>::iterator i;
+        tmp.resize(cand.size());
+        i = std::set_difference(cand.begin(), cand.end(),
+            m_sorted.begin(), m_sorted.end(), tmp.begin());
+        tmp.resize(i - tmp.begin());
+        cand.swap(tmp);
+        tmp.resize(m_sorted.size() + cand.size());
+        i = std::merge(cand.begin(), cand.end(),
+            m_sorted.begin(), m_sorted.end(), tmp.begin());
+        tmp.resize(i - tmp.begin());
+        m_sorted.swap(tmp);
+    }
+
+};
+
+
+/** \brief Merges two sorted lists of indexes
+ **/
+class gen_bto_contract2_nzorb_merge_task : public libutil::task_i {
+private:
+    std::vector<size_t> &m_l1; //!< First list (becomes the result)
+    std::vector<size_t> &m_l2; //!< Second list (cleared)
+
+public:
+    gen_bto_contract2_nzorb_merge_task(std::vector<size_t> &l1,
+        std::vector<size_t> &l2) :
+        m_l1(l1), m_l2(l2)
+    { }
+
+    virtual ~gen_bto_contract2_nzorb_merge_task() { }
+    virtual unsigned long get_cost() const { return m_l1.size() + m_l2.size(); }
+
+    virtual void perform() {
+        std::vector<size_t> l3(m_l1.size() + m_l2.size());
+        std::merge(m_l1.begin(), m_l1.end(), m_l2.begin(), m_l2.end(),
+            l3.begin());
+        m_l1.swap(l3);
+        std::vector<size_t>().swap(m_l2);
+    }
+
+};
+
+
+/** \brief Iterates over pairs of lists merged in one round of a pairwise
+        merge
+ **/
+class gen_bto_contract2_nzorb_merge_task_iterator :
+    public libutil::task_iterator_i {
+
+private:
+    std::vector< std::vector<size_t> > &m_lists; //!< Lists
+    size_t m_i; //!< Current pair
+
+public:
+    gen_bto_contract2_nzorb_merge_task_iterator(
+        std::vector< std::vector<size_t> > &lists) :
+        m_lists(lists), m_i(0)
+    { }
+
+    virtual bool has_more() const {
+        return 2 * m_i + 1 < m_lists.size();
+    }
+
+    virtual libutil::task_i *get_next() {
+        libutil::task_i *t = new gen_bto_contract2_nzorb_merge_task(
+            m_lists[2 * m_i], m_lists[2 * m_i + 1]);
+        m_i++;
+        return t;
+    }
+
+};
+
+
 template<size_t N, size_t M, size_t K, typename Traits>
 struct gen_bto_contract2_nzorb_task_ctx {
 public:
@@ -48,10 +163,9 @@ public:
     const block_list<NA> &m_blsta;
     const block_list<NB> &m_blstb;
     const gen_bto_contract2_block_list<N, M, K> &m_cbl;
-    std::vector<size_t> &m_visited;
-    std::vector<size_t> &m_nonzero;
-    libutil::mutex &m_vis_mtx;
-    libutil::mutex &m_nz_mtx;
+    gen_bto_contract2_nzorb_visited m_visited;
+    std::vector< std::vector<size_t> > &m_nonzero;
+    libutil::mutex m_nz_mtx;
 
 public:
     gen_bto_contract2_nzorb_task_ctx(
@@ -62,20 +176,25 @@ public:
         const block_list<NA> &blsta,
         const block_list<NB> &blstb,
         const gen_bto_contract2_block_list<N, M, K> &cbl,
-        std::vector<size_t> &visited,
-        std::vector<size_t> &nonzero,
-        libutil::mutex &vis_mtx,
-        libutil::mutex &nz_mtx) :
+        std::vector< std::vector<size_t> > &nonzero) :
 
         m_contr(contr), m_syma(syma), m_symb(symb), m_symc(symc),
         m_bidimsa(syma.get_bis().get_block_index_dims()),
         m_bidimsb(symb.get_bis().get_block_index_dims()),
         m_bidimsc(symc.get_bis().get_block_index_dims()),
         m_blsta(blsta), m_blstb(blstb), m_cbl(cbl),
-        m_visited(visited), m_nonzero(nonzero),
-        m_vis_mtx(vis_mtx), m_nz_mtx(nz_mtx)
+        m_visited(K == 0 ? 0 : m_bidimsc.get_size()), m_nonzero(nonzero)
     { }
 
+    /** \brief Adds a sorted list of nonzero canonical indexes
+     **/
+    void add_nonzero(std::vector<size_t> &nonzero) {
+        if(nonzero.empty()) return;
+        libutil::auto_lock<libutil::mutex> lock(m_nz_mtx);
+        m_nonzero.push_back(std::vector<size_t>());
+        m_nonzero.back().swap(nonzero);
+    }
+
 };
 
 
@@ -97,13 +216,14 @@ public:
 
 private:
     gen_bto_contract2_nzorb_task_ctx<N, M, K, Traits> &m_ctx;
-    size_t m_k;
+    size_t m_k; //!< Contracted index
+    size_t m_ia1, m_ia2; //!< Range of entries in the list of A blocks
 
 public:
     gen_bto_contract2_nzorb_task(
         gen_bto_contract2_nzorb_task_ctx<N, M, K, Traits> &ctx,
-        size_t k) :
-        m_ctx(ctx), m_k(k)
+        size_t k, size_t ia1, size_t ia2) :
+        m_ctx(ctx), m_k(k), m_ia1(ia1), m_ia2(ia2)
     { }
 
     virtual ~gen_bto_contract2_nzorb_task() { }
@@ -163,10 +283,23 @@ public:
     //! Block tensor interface traits
     typedef typename Traits::bti_traits bti_traits;
 
+public:
+    //! Max number of blocks of A per task
+    static const size_t k_max_blocks = 64;
+
+private:
+    /** \brief Blocks of A with the same contracted index processed by one
+            task
+     **/
+    struct task_range {
+        size_t k; //!< Contracted index
+        size_t ia1, ia2; //!< First and past-the-last blocks of A
+    };
+
 private:
     gen_bto_contract2_nzorb_task_ctx<N, M, K, Traits> &m_ctx;
-    std::vector<size_t> m_k;
-    typename std::vector<size_t>::const_iterator m_i;
+    std::vector<task_range> m_tasks; //!< Tasks
+    typename std::vector<task_range>::const_iterator m_i;
 
 public:
     gen_bto_contract2_nzorb_task_iterator(
@@ -272,12 +405,11 @@ gen_bto_contract2_nzorb<N, M, K, Traits>::gen_bto_contract2_nzorb(
         m_blsta.add(scha.get_abs_index(ia));
     }
 
-    orbit_list<NB, element_type> olb(m_symb);
+    std::vector<size_t> blst;
+    cb.req_nonzero_blocks(blst);
+    orbit_list<NB, element_type> olb(m_symb, blst);
     for(typename orbit_list<NB, element_type>::iterator iol = olb.begin();
         iol != olb.end(); ++iol) {
-        index<NB> idx;
-        olb.get_index(iol, idx);
-        if(cb.req_is_zero_block(idx)) continue;
         m_blstb.add(olb.get_abs_index(iol));
     }
 }
@@ -303,12 +435,11 @@ gen_bto_contract2_nzorb<N, M, K, Traits>::gen_bto_contract2_nzorb(
     so_copy<NB, element_type>(symb).perform(m_symb);
     so_copy<NC, element_type>(symc).perform(m_symc);
 
-    orbit_list<NA, element_type> ola(m_syma);
+    std::vector<size_t> blst;
+    ca.req_nonzero_blocks(blst);
+    orbit_list<NA, element_type> ola(m_syma, blst);
     for(typename orbit_list<NA, element_type>::iterator iol = ola.begin();
         iol != ola.end(); ++iol) {
-        index<NA> idx;
-        ola.get_index(iol, idx);
-        if(ca.req_is_zero_block(idx)) continue;
         m_blsta.add(ola.get_abs_index(iol));
     }
 
@@ -364,17 +495,28 @@ void gen_bto_contract2_nzorb<N, M, K, Traits>::build() {
     gen_bto_contract2_block_list<N, M, K> cbl(m_contr, bidimsa, blstax,
         bidimsb, blstbx);
 
-    std::vector<size_t> blstc, vis;
-    libutil::mutex blstc_mtx, vis_mtx;
+    std::vector< std::vector<size_t> > blstc;
     gen_bto_contract2_nzorb_task_ctx<N, M, K, Traits> tctx(m_contr,
-        m_syma, m_symb, m_symc, blstax, blstbx, cbl, vis, blstc, vis_mtx,
-        blstc_mtx);
+        m_syma, m_symb, m_symc, blstax, blstbx, cbl, blstc);
 
     gen_bto_contract2_nzorb_task_iterator<N, M, K, Traits> ti(tctx);
     gen_bto_contract2_nzorb_task_observer<N, M, K> to;
     libutil::thread_pool::submit(ti, to);
 
-    for(size_t i = 0; i < blstc.size(); i++) m_blstc.add(blstc[i]);
+    //  Each task produced a sorted list of unique indexes,
+    //  merge them pairwise in parallel
+    while(blstc.size() > 1) {
+        gen_bto_contract2_nzorb_merge_task_iterator mti(blstc);
+        libutil::thread_pool::submit(mti, to);
+        size_t j = 0;
+        for(size_t i = 0; i < blstc.size(); i += 2) blstc[j++].swap(blstc[i]);
+        blstc.resize(j);
+    }
+
+    if(!blstc.empty()) {
+        const std::vector<size_t> &l = blstc[0];
+        for(size_t i = 0; i < l.size(); i++) m_blstc.add(l[i]);
+    }
 }
 
 
@@ -412,12 +554,13 @@ void gen_bto_contract2_nzorb_task<N, M, K, Traits>::perform() {
 
     gen_bto_contract2_block_list_less_1 comp_1;
     index<2> isrch2; isrch2[0] = m_k;
-    typename std::vector< index<2> >::const_iterator ia =
-        std::lower_bound(bla.begin(), bla.end(), isrch2, comp_1);
+    typename std::vector< index<2> >::const_iterator ia = bla.begin() + m_ia1;
+    typename std::vector< index<2> >::const_iterator iaend =
+        bla.begin() + m_ia2;
     typename std::vector< index<2> >::const_iterator ib =
         std::lower_bound(blb.begin(), blb.end(), isrch2, comp_1);
     index<NC> ici, icj, ic;
-    while(ia != bla.end() && ia->at(0) == m_k) {
+    while(ia != iaend) {
         abs_index<NC>::get_index(ia->at(1), dimsci, ici);
         typename std::vector< index<2> >::const_iterator ib1 = ib;
         while(ib1 != blb.end() && ib1->at(0) == m_k) {
@@ -434,22 +577,9 @@ void gen_bto_contract2_nzorb_task<N, M, K, Traits>::perform() {
         ++ia;
     }
     std::sort(candidates.begin(), candidates.end());
-
-    {
-        libutil::auto_lock<libutil::mutex> lock(m_ctx.m_vis_mtx);
-        std::vector<size_t> tmp;
-        typename std::vector<size_t>::iterator i;
-        tmp.resize(candidates.size());
-        i = std::set_difference(candidates.begin(), candidates.end(),
-            m_ctx.m_visited.begin(), m_ctx.m_visited.end(), tmp.begin());
-        tmp.resize(i - tmp.begin());
-        candidates.swap(tmp);
-        tmp.resize(m_ctx.m_visited.size() + candidates.size());
-        i = std::merge(candidates.begin(), candidates.end(),
-            m_ctx.m_visited.begin(), m_ctx.m_visited.end(), tmp.begin());
-        tmp.resize(i - tmp.begin());
-        m_ctx.m_visited.swap(tmp);
-    }
+    candidates.resize(std::unique(candidates.begin(), candidates.end()) -
+        candidates.begin());
+    m_ctx.m_visited.visit(candidates);
 
     nonzero.reserve(candidates.size());
     for(typename std::vector<size_t>::iterator i = candidates.begin();
@@ -464,16 +594,7 @@ void gen_bto_contract2_nzorb_task<N, M, K, Traits>::perform() {
         if(!bld.is_empty()) nonzero.push_back(*i);
     }
 
-    {
-        libutil::auto_lock<libutil::mutex> lock(m_ctx.m_nz_mtx);
-        std::vector<size_t> nznew;
-        nznew.resize(m_ctx.m_nonzero.size() + nonzero.size());
-        typename std::vector<size_t>::iterator i = std::merge(
-            nonzero.begin(), nonzero.end(),
-            m_ctx.m_nonzero.begin(), m_ctx.m_nonzero.end(), nznew.begin());
-        nznew.resize(i - nznew.begin());
-        m_ctx.m_nonzero.swap(nznew);
-    }
+    m_ctx.add_nonzero(nonzero);
 }
 
 
@@ -520,16 +641,7 @@ void gen_bto_contract2_nzorb_task<N, M, 0, Traits>::perform() {
     }
     std::sort(nonzero.begin(), nonzero.end());
 
-    {
-        libutil::auto_lock<libutil::mutex> lock(m_ctx.m_nz_mtx);
-        std::vector<size_t> nznew;
-        nznew.resize(m_ctx.m_nonzero.size() + nonzero.size());
-        typename std::vector<size_t>::iterator i = std::merge(
-            nonzero.begin(), nonzero.end(),
-            m_ctx.m_nonzero.begin(), m_ctx.m_nonzero.end(), nznew.begin());
-        nznew.resize(i - nznew.begin());
-        m_ctx.m_nonzero.swap(nznew);
-    }
+    m_ctx.add_nonzero(nonzero);
 }
 
 
@@ -573,19 +685,38 @@ gen_bto_contract2_nzorb_task_iterator(
         ++ib;
     }
 
-    m_k.resize(std::max(ka.size(), kb.size()));
+    std::vector<size_t> kab(std::max(ka.size(), kb.size()));
     typename std::vector<size_t>::iterator kend =
         std::set_intersection(ka.begin(), ka.end(), kb.begin(), kb.end(),
-            m_k.begin());
-    m_k.resize(kend - m_k.begin());
-    m_i = m_k.begin();
+            kab.begin());
+    kab.resize(kend - kab.begin());
+
+    //  Split the blocks of A for each contracted index into ranges
+    const std::vector< index<2> > &bla = m_ctx.m_cbl.get_blsta_1();
+    gen_bto_contract2_block_list_less_1 comp_1;
+    for(size_t i = 0; i < kab.size(); i++) {
+        index<2> isrch2; isrch2[0] = kab[i];
+        size_t ia1 = std::lower_bound(bla.begin(), bla.end(), isrch2, comp_1) -
+            bla.begin();
+        size_t ia2 = ia1;
+        while(ia2 < bla.size() && bla[ia2][0] == kab[i]) ia2++;
+        while(ia1 < ia2) {
+            task_range t;
+            t.k = kab[i];
+            t.ia1 = ia1;
+            t.ia2 = std::min(ia1 + k_max_blocks, ia2);
+            m_tasks.push_back(t);
+            ia1 = t.ia2;
+        }
+    }
+    m_i = m_tasks.begin();
 }
 
 
 template<size_t N, size_t M, size_t K, typename Traits>
 bool gen_bto_contract2_nzorb_task_iterator<N, M, K, Traits>::has_more() const {
 
-    return m_i != m_k.end();
+    return m_i != m_tasks.end();
 }
 
 
@@ -594,7 +725,8 @@ libutil::task_i*
 gen_bto_contract2_nzorb_task_iterator<N, M, K, Traits>::get_next() {
 
     gen_bto_contract2_nzorb_task<N, M, K, Traits> *t =
-        new gen_bto_contract2_nzorb_task<N, M, K, Traits>(m_ctx, *m_i);
+        new gen_bto_contract2_nzorb_task<N, M, K, Traits>(m_ctx,
+            m_i->k, m_i->ia1, m_i->ia2);
     ++m_i;
     return t;
 }
@@ -213,17 +213,19 @@ void gen_bto_contract3<N1, N2, N3, K1, K2, Traits, Timed>::perform(
             m_schab.begin();
         while (ibab != m_schab.end()) {
 
+            //  Batch sizes adapt to the memory in use before each batch
+            size_t bszab = batching_policy_base::scale(batchszab);
             batchab1.clear();
             batchab2.clear();
             if (permab1.is_identity()) {
                 for(; ibab != m_schab.end() &&
-                        batchab1.size() < batchszab; ++ibab) {
+                        batchab1.size() < bszab; ++ibab) {
                     batchab1.push_back(m_schab.get_abs_index(ibab));
                 }
             }
             else {
                 for(; ibab != m_schab.end() &&
-                        batchab1.size() < batchszab; ++ibab) {
+                        batchab1.size() < bszab; ++ibab) {
 
                     index<NAB> iab;
                     abs_index<NAB>::get_index(*ibab, bidimsab, iab);
@@ -238,8 +240,10 @@ void gen_bto_contract3<N1, N2, N3, K1, K2, Traits, Timed>::perform(
             gen_bto_aux_copy<NAB, Traits> ab1cout(symab1, btab1);
             ab1cout.open();
             compute_batch_ab(contr1,
-                    bidimsa, perma, symat, batchsza,
-                    bidimsb, permb, symbt, batchszb,
+                    bidimsa, perma, symat,
+                    batching_policy_base::scale(batchsza),
+                    bidimsb, permb, symbt,
+                    batching_policy_base::scale(batchszb),
                     bisab1, batchab1, ab1cout);
             ab1cout.close();
 
@@ -262,13 +266,14 @@ void gen_bto_contract3<N1, N2, N3, K1, K2, Traits, Timed>::perform(
 
             for(size_t ibc = 0; ibc < nblkc;) {
 
+                size_t bszc = batching_policy_base::scale(batchszc);
                 batchc.clear();
                 if(permc.is_identity()) {
-                    for(; ibc < nblkc && batchc.size() < batchszc; ibc++) {
+                    for(; ibc < nblkc && batchc.size() < bszc; ibc++) {
                         batchc.push_back(blstc[ibc]);
                     }
                 } else {
-                    for(; ibc < nblkc && batchc.size() < batchszc; ibc++) {
+                    for(; ibc < nblkc && batchc.size() < bszc; ibc++) {
                         index<NC> ic;
                         abs_index<NC>::get_index(blstc[ibc], bidimsc, ic);
                         ic.permute(permc);
@@ -300,9 +305,10 @@ void gen_bto_contract3<N1, N2, N3, K1, K2, Traits, Timed>::perform(
                     m_schd.begin();
                 while(ibd != m_schd.end()) {
 
+                    size_t bszd = batching_policy_base::scale(batchszd);
                     batchd.clear();
 
-                    for(; ibd != m_schd.end() && batchd.size() < batchszd;
+                    for(; ibd != m_schd.end() && batchd.size() < bszd;
                             ++ibd) {
                         index<ND> id;
                         abs_index<ND>::get_index(m_schd.get_abs_index(ibd),
@@ -0,0 +1,417 @@
+#ifndef LIBTENSOR_GEN_BTO_DIV_DIRSUM_IMPL_H
+#define LIBTENSOR_GEN_BTO_DIV_DIRSUM_IMPL_H
+
+#include <libutil/thread_pool/thread_pool.h>
+#include <libtensor/core/abs_index.h>
+#include <libtensor/core/bad_block_index_space.h>
+#include <libtensor/core/block_index_space_product_builder.h>
+#include <libtensor/core/orbit.h>
+#include <libtensor/core/orbit_list.h>
+#include <libtensor/symmetry/so_dirprod.h>
+#include <libtensor/symmetry/so_merge.h>
+#include "../gen_block_tensor_ctrl.h"
+#include "../gen_bto_div_dirsum.h"
+#include "gen_bto_dirsum_sym_impl.h"
+
+namespace libtensor {
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+const char gen_bto_div_dirsum<N, M, Traits, Timed>::k_clazz[] =
+        "gen_bto_div_dirsum<N, M, Traits, Timed>";
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+class gen_bto_div_dirsum_task : public libutil::task_i {
+public:
+    enum {
+        NC = N + M
+    };
+
+    typedef typename Traits::element_type element_type;
+    typedef typename Traits::bti_traits bti_traits;
+    typedef typename Traits::template temp_block_tensor_type<NC>::type
+        temp_block_tensor_type;
+
+private:
+    gen_bto_div_dirsum<N, M, Traits, Timed> &m_bto;
+    temp_block_tensor_type &m_btc;
+    index<NC> m_idx;
+    gen_block_stream_i<NC, bti_traits> &m_out;
+
+public:
+    gen_bto_div_dirsum_task(
+        gen_bto_div_dirsum<N, M, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        const index<NC> &idx,
+        gen_block_stream_i<NC, bti_traits> &out);
+
+    virtual ~gen_bto_div_dirsum_task() { }
+    virtual unsigned long get_cost() const { return 0; }
+    virtual void perform();
+
+};
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+class gen_bto_div_dirsum_task_iterator : public libutil::task_iterator_i {
+public:
+    enum {
+        NC = N + M
+    };
+
+    typedef typename Traits::element_type element_type;
+    typedef typename Traits::bti_traits bti_traits;
+    typedef typename Traits::template temp_block_tensor_type<NC>::type
+        temp_block_tensor_type;
+
+private:
+    gen_bto_div_dirsum<N, M, Traits, Timed> &m_bto;
+    temp_block_tensor_type &m_btc;
+    gen_block_stream_i<NC, bti_traits> &m_out;
+    const assignment_schedule<NC, element_type> &m_sch;
+    typename assignment_schedule<NC, element_type>::iterator m_i;
+
+public:
+    gen_bto_div_dirsum_task_iterator(
+        gen_bto_div_dirsum<N, M, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        gen_block_stream_i<NC, bti_traits> &out);
+
+    virtual bool has_more() const;
+    virtual libutil::task_i *get_next();
+
+};
+
+
+template<size_t N, size_t M, typename Traits>
+class gen_bto_div_dirsum_task_observer : public libutil::task_observer_i {
+public:
+    virtual void notify_start_task(libutil::task_i *t) { }
+    virtual void notify_finish_task(libutil::task_i *t);
+
+};
+
+
+/** \brief Copies a block of a term of the direct sum into a temporary block
+        in the requested orientation; zeros the temporary block and returns
+        false if the block is zero
+ **/
+template<size_t N, typename Traits>
+bool gen_bto_div_dirsum_get_block(
+    gen_block_tensor_rd_i<N, typename Traits::bti_traits> &bt,
+    const index<N> &idx,
+    typename Traits::template temp_block_type<N>::type &blk) {
+
+    typedef typename Traits::element_type element_type;
+    typedef typename Traits::bti_traits bti_traits;
+    typedef typename bti_traits::template rd_block_type<N>::type
+        rd_block_type;
+    typedef typename Traits::template to_copy_type<N>::type to_copy_type;
+    typedef typename Traits::template to_set_type<N>::type to_set_type;
+
+    gen_block_tensor_rd_ctrl<N, bti_traits> ctrl(bt);
+
+    orbit<N, element_type> o(ctrl.req_const_symmetry(), idx);
+    if(!o.is_allowed() || ctrl.req_is_zero_block(o.get_cindex())) {
+        to_set_type().perform(true, blk);
+        return false;
+    }
+
+    rd_block_type &blk0 = ctrl.req_const_block(o.get_cindex());
+    to_copy_type(blk0, o.get_transf(idx)).perform(true, blk);
+    ctrl.ret_const_block(o.get_cindex());
+    return true;
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+gen_bto_div_dirsum<N, M, Traits, Timed>::gen_bto_div_dirsum(
+    additive_gen_bto<NC, bti_traits> &opn,
+    gen_block_tensor_rd_i<NA, bti_traits> &bta,
+    const scalar_transf_type &ka,
+    gen_block_tensor_rd_i<NB, bti_traits> &btb,
+    const scalar_transf_type &kb,
+    const permutation<NC> &perms,
+    const scalar_transf_type &trc) :
+
+    m_opn(opn), m_bta(bta), m_btb(btb), m_ka(ka), m_kb(kb), m_perms(perms),
+    m_trc(trc), m_syms(bta, ka, btb, kb, perms), m_bisc(m_opn.get_bis()),
+    m_symc(m_bisc), m_sch(m_bisc.get_block_index_dims()) {
+
+    static const char method[] = "gen_bto_div_dirsum("
+            "additive_gen_bto<NC, bti_traits>&, "
+            "gen_block_tensor_rd_i<NA, bti_traits>&, "
+            "const scalar_transf_type&, "
+            "gen_block_tensor_rd_i<NB, bti_traits>&, "
+            "const scalar_transf_type&, const permutation<NC>&, "
+            "const scalar_transf_type&)";
+
+    block_index_space<NC> biss(m_syms.get_bis()), bisc1(m_bisc);
+    biss.match_splits();
+    bisc1.match_splits();
+    if(!bisc1.equals(biss)) {
+        throw bad_block_index_space(g_ns, k_clazz, method,
+            __FILE__, __LINE__, "opn, bta, btb");
+    }
+
+    //  The result has the symmetry the numerator and the denominator
+    //  have in common
+
+    block_index_space_product_builder<NC, NC> bbx(m_bisc, m_bisc,
+            permutation<NC + NC>());
+
+    symmetry<NC + NC, element_type> symx(bbx.get_bis());
+    so_dirprod<NC, NC, element_type>(m_opn.get_symmetry(),
+            m_syms.get_symmetry(), permutation<NC + NC>()).perform(symx);
+    mask<NC + NC> msk;
+    sequence<NC + NC, size_t> seq;
+    for (register size_t i = 0; i < NC; i++) {
+        msk[i] = msk[i + NC] = true;
+        seq[i] = seq[i + NC] = i;
+    }
+    so_merge<NC + NC, NC, element_type>(symx, msk, seq).perform(m_symc);
+
+    make_schedule();
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+void gen_bto_div_dirsum<N, M, Traits, Timed>::perform(
+        gen_block_stream_i<NC, bti_traits> &out) {
+
+    typedef typename Traits::template temp_block_tensor_type<NC>::type
+        temp_block_tensor_type;
+
+    gen_bto_div_dirsum::start_timer();
+
+    try {
+
+        temp_block_tensor_type btc(m_bisc);
+
+        gen_bto_div_dirsum_task_iterator<N, M, Traits, Timed> ti(*this, btc,
+            out);
+        gen_bto_div_dirsum_task_observer<N, M, Traits> to;
+        libutil::thread_pool::submit(ti, to);
+
+    } catch(...) {
+        gen_bto_div_dirsum::stop_timer();
+        throw;
+    }
+
+    gen_bto_div_dirsum::stop_timer();
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+void gen_bto_div_dirsum<N, M, Traits, Timed>::compute_block(
+        bool zero,
+        const index<NC> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc) {
+
+    gen_bto_div_dirsum::start_timer("compute_block");
+
+    try {
+
+        compute_block_untimed(zero, ic, trc, blkc);
+
+    } catch (...) {
+        gen_bto_div_dirsum::stop_timer("compute_block");
+        throw;
+    }
+
+    gen_bto_div_dirsum::stop_timer("compute_block");
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+void gen_bto_div_dirsum<N, M, Traits, Timed>::compute_block_untimed(
+        bool zero,
+        const index<NC> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc) {
+
+    typedef typename Traits::template temp_block_type<NA>::type
+        temp_block_a_type;
+    typedef typename Traits::template temp_block_type<NB>::type
+        temp_block_b_type;
+    typedef typename Traits::template temp_block_type<NC>::type
+        temp_block_c_type;
+    typedef typename Traits::template to_div_dirsum_type<NA, NB>::type
+        to_div_dirsum_type;
+    typedef typename Traits::template to_set_type<NC>::type to_set_type;
+
+    static const char method[] = "compute_block_untimed(bool, "
+        "const index<NC>&, const tensor_transf_type&, wr_block_type&)";
+
+    orbit<NC, element_type> on(m_opn.get_symmetry(), ic);
+    if(!on.is_allowed() || !m_opn.get_schedule().contains(on.get_acindex())) {
+        if(zero) to_set_type().perform(zero, blkc);
+        return;
+    }
+
+    //  Compute the block of the numerator
+
+    dimensions<NC> bidims(m_bisc.get_block_index_dims());
+    abs_index<NC> cin(on.get_acindex(), bidims);
+    temp_block_c_type blkn(m_bisc.get_block_dims(ic));
+    m_opn.compute_block(true, cin.get_index(), on.get_transf(ic), blkn);
+
+    //  Fetch the blocks of A and B that make up the block of the denominator
+
+    index<NC> is(ic);
+    is.permute(permutation<NC>(m_perms, true));
+    index<NA> ia;
+    index<NB> ib;
+    for(size_t i = 0; i < NA; i++) ia[i] = is[i];
+    for(size_t i = 0; i < NB; i++) ib[i] = is[NA + i];
+
+    temp_block_a_type blka(m_bta.get_bis().get_block_dims(ia));
+    temp_block_b_type blkb(m_btb.get_bis().get_block_dims(ib));
+    bool nza = gen_bto_div_dirsum_get_block<NA, Traits>(m_bta, ia, blka);
+    bool nzb = gen_bto_div_dirsum_get_block<NB, Traits>(m_btb, ib, blkb);
+    if(!nza && !nzb) {
+        throw bad_parameter(g_ns, k_clazz, method,
+                __FILE__, __LINE__, "zero in denominator");
+    }
+
+    tensor_transf_type trc1(trc);
+    trc1.transform(m_trc);
+
+    to_div_dirsum_type(blkn, blka, m_ka, blkb, m_kb, m_perms, trc1).
+        perform(zero, blkc);
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+void gen_bto_div_dirsum<N, M, Traits, Timed>::make_schedule() {
+
+    static const char method[] = "make_schedule()";
+
+    gen_block_tensor_rd_ctrl<NA, bti_traits> ca(m_bta);
+    gen_block_tensor_rd_ctrl<NB, bti_traits> cb(m_btb);
+
+    const symmetry<NA, element_type> &syma = ca.req_const_symmetry();
+    const symmetry<NB, element_type> &symb = cb.req_const_symmetry();
+    const symmetry<NC, element_type> &symn = m_opn.get_symmetry();
+    const assignment_schedule<NC, element_type> &schn = m_opn.get_schedule();
+
+    permutation<NC> pinv(m_perms, true);
+
+    orbit_list<NC, element_type> ol(m_symc);
+
+    for (typename orbit_list<NC, element_type>::iterator iol = ol.begin();
+            iol != ol.end(); iol++) {
+
+        index<NC> idx;
+        ol.get_index(iol, idx);
+
+        orbit<NC, element_type> on(symn, idx);
+        if (! on.is_allowed()) continue;
+        bool zeron = !schn.contains(on.get_acindex());
+
+        index<NC> is(idx);
+        is.permute(pinv);
+        index<NA> ia;
+        index<NB> ib;
+        for(size_t i = 0; i < NA; i++) ia[i] = is[i];
+        for(size_t i = 0; i < NB; i++) ib[i] = is[NA + i];
+
+        orbit<NA, element_type> oa(syma, ia);
+        bool zeroa = !oa.is_allowed() || ca.req_is_zero_block(oa.get_cindex());
+        orbit<NB, element_type> ob(symb, ib);
+        bool zerob = !ob.is_allowed() || cb.req_is_zero_block(ob.get_cindex());
+
+        if (zeroa && zerob) {
+            throw bad_parameter(g_ns, k_clazz, method,
+                    __FILE__, __LINE__, "zero in denominator");
+        }
+
+        if (! zeron) m_sch.insert(idx);
+    }
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+gen_bto_div_dirsum_task<N, M, Traits, Timed>::gen_bto_div_dirsum_task(
+        gen_bto_div_dirsum<N, M, Traits, Timed> &bto,
+        temp_block_tensor_type &btc, const index<NC> &idx,
+        gen_block_stream_i<NC, bti_traits> &out) :
+
+    m_bto(bto), m_btc(btc), m_idx(idx), m_out(out) {
+
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+void gen_bto_div_dirsum_task<N, M, Traits, Timed>::perform() {
+
+    typedef typename bti_traits::template rd_block_type<NC>::type
+            rd_block_type;
+    typedef typename bti_traits::template wr_block_type<NC>::type
+            wr_block_type;
+
+    tensor_transf<NC, element_type> tr0;
+    gen_block_tensor_ctrl<NC, bti_traits> cc(m_btc);
+    {
+        wr_block_type &blkc = cc.req_block(m_idx);
+        m_bto.compute_block_untimed(true, m_idx, tr0, blkc);
+        cc.ret_block(m_idx);
+    }
+
+    {
+        rd_block_type &blkc = cc.req_const_block(m_idx);
+        m_out.put(m_idx, blkc, tr0);
+        cc.ret_const_block(m_idx);
+    }
+    cc.req_zero_block(m_idx);
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+gen_bto_div_dirsum_task_iterator<N, M, Traits, Timed>::
+gen_bto_div_dirsum_task_iterator(
+        gen_bto_div_dirsum<N, M, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        gen_block_stream_i<NC, bti_traits> &out) :
+
+    m_bto(bto), m_btc(btc), m_out(out), m_sch(m_bto.get_schedule()),
+    m_i(m_sch.begin()) {
+
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+bool gen_bto_div_dirsum_task_iterator<N, M, Traits, Timed>::has_more() const {
+
+    return m_i != m_sch.end();
+}
+
+
+template<size_t N, size_t M, typename Traits, typename Timed>
+libutil::task_i *
+gen_bto_div_dirsum_task_iterator<N, M, Traits, Timed>::get_next() {
+
+    dimensions<NC> bidims = m_btc.get_bis().get_block_index_dims();
+    index<NC> idx;
+    abs_index<NC>::get_index(m_sch.get_abs_index(m_i), bidims, idx);
+    gen_bto_div_dirsum_task<N, M, Traits, Timed> *t =
+        new gen_bto_div_dirsum_task<N, M, Traits, Timed>(m_bto, m_btc, idx,
+            m_out);
+    ++m_i;
+    return t;
+}
+
+
+template<size_t N, size_t M, typename Traits>
+void gen_bto_div_dirsum_task_observer<N, M, Traits>::notify_finish_task(
+    libutil::task_i *t) {
+
+    delete t;
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_GEN_BTO_DIV_DIRSUM_IMPL_H
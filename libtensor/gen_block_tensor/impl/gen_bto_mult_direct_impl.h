@@ -0,0 +1,353 @@
+#ifndef LIBTENSOR_GEN_BTO_MULT_DIRECT_IMPL_H
+#define LIBTENSOR_GEN_BTO_MULT_DIRECT_IMPL_H
+
+#include <libutil/thread_pool/thread_pool.h>
+#include <libtensor/core/abs_index.h>
+#include <libtensor/core/bad_block_index_space.h>
+#include <libtensor/core/block_index_space_product_builder.h>
+#include <libtensor/core/orbit.h>
+#include <libtensor/core/orbit_list.h>
+#include <libtensor/symmetry/so_dirprod.h>
+#include <libtensor/symmetry/so_merge.h>
+#include "../gen_block_tensor_ctrl.h"
+#include "../gen_bto_mult_direct.h"
+
+namespace libtensor {
+
+
+template<size_t N, typename Traits, typename Timed>
+const char gen_bto_mult_direct<N, Traits, Timed>::k_clazz[] =
+        "gen_bto_mult_direct<N, Traits, Timed>";
+
+
+template<size_t N, typename Traits, typename Timed>
+class gen_bto_mult_direct_task : public libutil::task_i {
+public:
+    typedef typename Traits::element_type element_type;
+    typedef typename Traits::bti_traits bti_traits;
+    typedef typename Traits::template temp_block_tensor_type<N>::type
+        temp_block_tensor_type;
+
+private:
+    gen_bto_mult_direct<N, Traits, Timed> &m_bto;
+    temp_block_tensor_type &m_btc;
+    index<N> m_idx;
+    gen_block_stream_i<N, bti_traits> &m_out;
+
+public:
+    gen_bto_mult_direct_task(
+        gen_bto_mult_direct<N, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        const index<N> &idx,
+        gen_block_stream_i<N, bti_traits> &out);
+
+    virtual ~gen_bto_mult_direct_task() { }
+    virtual unsigned long get_cost() const { return 0; }
+    virtual void perform();
+
+};
+
+
+template<size_t N, typename Traits, typename Timed>
+class gen_bto_mult_direct_task_iterator : public libutil::task_iterator_i {
+public:
+    typedef typename Traits::element_type element_type;
+    typedef typename Traits::bti_traits bti_traits;
+    typedef typename Traits::template temp_block_tensor_type<N>::type
+        temp_block_tensor_type;
+
+private:
+    gen_bto_mult_direct<N, Traits, Timed> &m_bto;
+    temp_block_tensor_type &m_btc;
+    gen_block_stream_i<N, bti_traits> &m_out;
+    const assignment_schedule<N, element_type> &m_sch;
+    typename assignment_schedule<N, element_type>::iterator m_i;
+
+public:
+    gen_bto_mult_direct_task_iterator(
+        gen_bto_mult_direct<N, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        gen_block_stream_i<N, bti_traits> &out);
+
+    virtual bool has_more() const;
+    virtual libutil::task_i *get_next();
+
+};
+
+
+template<size_t N, typename Traits>
+class gen_bto_mult_direct_task_observer : public libutil::task_observer_i {
+public:
+    virtual void notify_start_task(libutil::task_i *t) { }
+    virtual void notify_finish_task(libutil::task_i *t);
+
+};
+
+
+template<size_t N, typename Traits, typename Timed>
+gen_bto_mult_direct<N, Traits, Timed>::gen_bto_mult_direct(
+    additive_gen_bto<N, bti_traits> &opa,
+    additive_gen_bto<N, bti_traits> &opb,
+    bool recip, const scalar_transf<element_type> &trc) :
+
+    m_opa(opa), m_opb(opb), m_recip(recip), m_trc(trc),
+    m_bisc(m_opa.get_bis()), m_symc(m_bisc),
+    m_sch(m_bisc.get_block_index_dims()) {
+
+    static const char method[] = "gen_bto_mult_direct("
+            "additive_gen_bto<N, bti_traits>&, "
+            "additive_gen_bto<N, bti_traits>&, "
+            "bool, const scalar_transf<element_type>&)";
+
+    block_index_space<N> bisb(m_opb.get_bis()), bisc1(m_bisc);
+    bisb.match_splits();
+    bisc1.match_splits();
+    if(!bisc1.equals(bisb)) {
+        throw bad_block_index_space(g_ns, k_clazz, method,
+            __FILE__, __LINE__, "opa, opb");
+    }
+
+    //  The result has the symmetry the arguments have in common
+
+    block_index_space_product_builder<N, N> bbx(m_bisc, m_bisc,
+            permutation<N + N>());
+
+    symmetry<N + N, element_type> symx(bbx.get_bis());
+    so_dirprod<N, N, element_type>(m_opa.get_symmetry(),
+            m_opb.get_symmetry(), permutation<N + N>()).perform(symx);
+    mask<N + N> msk;
+    sequence<N + N, size_t> seq;
+    for (register size_t i = 0; i < N; i++) {
+        msk[i] = msk[i + N] = true;
+        seq[i] = seq[i + N] = i;
+    }
+    so_merge<N + N, N, element_type>(symx, msk, seq).perform(m_symc);
+
+    make_schedule();
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+void gen_bto_mult_direct<N, Traits, Timed>::perform(
+        gen_block_stream_i<N, bti_traits> &out) {
+
+    typedef typename Traits::template temp_block_tensor_type<N>::type
+        temp_block_tensor_type;
+
+    gen_bto_mult_direct::start_timer();
+
+    try {
+
+        temp_block_tensor_type btc(m_bisc);
+
+        gen_bto_mult_direct_task_iterator<N, Traits, Timed> ti(*this, btc,
+            out);
+        gen_bto_mult_direct_task_observer<N, Traits> to;
+        libutil::thread_pool::submit(ti, to);
+
+    } catch(...) {
+        gen_bto_mult_direct::stop_timer();
+        throw;
+    }
+
+    gen_bto_mult_direct::stop_timer();
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+void gen_bto_mult_direct<N, Traits, Timed>::compute_block(
+        bool zero,
+        const index<N> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc) {
+
+    gen_bto_mult_direct::start_timer("compute_block");
+
+    try {
+
+        compute_block_untimed(zero, ic, trc, blkc);
+
+    } catch (...) {
+        gen_bto_mult_direct::stop_timer("compute_block");
+        throw;
+    }
+
+    gen_bto_mult_direct::stop_timer("compute_block");
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+void gen_bto_mult_direct<N, Traits, Timed>::compute_block_untimed(
+        bool zero,
+        const index<N> &ic,
+        const tensor_transf_type &trc,
+        wr_block_type &blkc) {
+
+    typedef typename Traits::template temp_block_type<N>::type
+        temp_block_type;
+    typedef typename Traits::template to_mult_type<N>::type to_mult;
+    typedef typename Traits::template to_set_type<N>::type to_set;
+
+    static const char method[] = "compute_block_untimed(bool, "
+        "const index<N>&, const tensor_transf_type&, wr_block_type&)";
+
+    if(zero) to_set().perform(zero, blkc);
+
+    dimensions<N> bidims(m_bisc.get_block_index_dims());
+
+    orbit<N, element_type> oa(m_opa.get_symmetry(), ic);
+    bool zeroa = !oa.is_allowed() ||
+        !m_opa.get_schedule().contains(oa.get_acindex());
+    orbit<N, element_type> ob(m_opb.get_symmetry(), ic);
+    bool zerob = !ob.is_allowed() ||
+        !m_opb.get_schedule().contains(ob.get_acindex());
+
+    if(m_recip && zerob) {
+        throw bad_parameter(g_ns, k_clazz, method,
+                __FILE__, __LINE__, "zero in opb");
+    }
+    if(zeroa || zerob) return;
+
+    //  Compute the blocks of both arguments, then combine them
+
+    dimensions<N> dims(m_bisc.get_block_dims(ic));
+    temp_block_type blka(dims), blkb(dims);
+
+    abs_index<N> cia(oa.get_acindex(), bidims), cib(ob.get_acindex(), bidims);
+    m_opa.compute_block(true, cia.get_index(), oa.get_transf(ic), blka);
+    m_opb.compute_block(true, cib.get_index(), ob.get_transf(ic), blkb);
+
+    tensor_transf_type tr(trc.get_perm());
+    scalar_transf<element_type> trc1(trc.get_scalar_tr());
+    trc1.transform(m_trc);
+
+    to_mult(blka, tr, blkb, tr, m_recip, trc1).perform(false, blkc);
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+void gen_bto_mult_direct<N, Traits, Timed>::make_schedule() {
+
+    static const char method[] = "make_schedule()";
+
+    const symmetry<N, element_type> &syma = m_opa.get_symmetry();
+    const symmetry<N, element_type> &symb = m_opb.get_symmetry();
+    const assignment_schedule<N, element_type> &scha = m_opa.get_schedule();
+    const assignment_schedule<N, element_type> &schb = m_opb.get_schedule();
+
+    orbit_list<N, element_type> ol(m_symc);
+
+    for (typename orbit_list<N, element_type>::iterator iol = ol.begin();
+            iol != ol.end(); iol++) {
+
+        index<N> idx;
+        ol.get_index(iol, idx);
+
+        orbit<N, element_type> oa(syma, idx);
+        if (! oa.is_allowed()) continue;
+        bool zeroa = !scha.contains(oa.get_acindex());
+
+        orbit<N, element_type> ob(symb, idx);
+        if (! ob.is_allowed()) {
+            if (m_recip)
+                throw bad_parameter(g_ns, k_clazz, method,
+                        __FILE__, __LINE__, "Block not allowed in opb.");
+
+            continue;
+        }
+        bool zerob = !schb.contains(ob.get_acindex());
+
+        if (m_recip && zerob) {
+            throw bad_parameter(g_ns, k_clazz, method,
+                    __FILE__, __LINE__, "zero in opb");
+        }
+
+        if (! zeroa && ! zerob) {
+            m_sch.insert(idx);
+        }
+    }
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+gen_bto_mult_direct_task<N, Traits, Timed>::gen_bto_mult_direct_task(
+        gen_bto_mult_direct<N, Traits, Timed> &bto,
+        temp_block_tensor_type &btc, const index<N> &idx,
+        gen_block_stream_i<N, bti_traits> &out) :
+
+    m_bto(bto), m_btc(btc), m_idx(idx), m_out(out) {
+
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+void gen_bto_mult_direct_task<N, Traits, Timed>::perform() {
+
+    typedef typename bti_traits::template rd_block_type<N>::type
+            rd_block_type;
+    typedef typename bti_traits::template wr_block_type<N>::type
+            wr_block_type;
+
+    tensor_transf<N, element_type> tr0;
+    gen_block_tensor_ctrl<N, bti_traits> cc(m_btc);
+    {
+        wr_block_type &blkc = cc.req_block(m_idx);
+        m_bto.compute_block_untimed(true, m_idx, tr0, blkc);
+        cc.ret_block(m_idx);
+    }
+
+    {
+        rd_block_type &blkc = cc.req_const_block(m_idx);
+        m_out.put(m_idx, blkc, tr0);
+        cc.ret_const_block(m_idx);
+    }
+    cc.req_zero_block(m_idx);
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+gen_bto_mult_direct_task_iterator<N, Traits, Timed>::
+gen_bto_mult_direct_task_iterator(
+        gen_bto_mult_direct<N, Traits, Timed> &bto,
+        temp_block_tensor_type &btc,
+        gen_block_stream_i<N, bti_traits> &out) :
+
+    m_bto(bto), m_btc(btc), m_out(out), m_sch(m_bto.get_schedule()),
+    m_i(m_sch.begin()) {
+
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+bool gen_bto_mult_direct_task_iterator<N, Traits, Timed>::has_more() const {
+
+    return m_i != m_sch.end();
+}
+
+
+template<size_t N, typename Traits, typename Timed>
+libutil::task_i *
+gen_bto_mult_direct_task_iterator<N, Traits, Timed>::get_next() {
+
+    dimensions<N> bidims = m_btc.get_bis().get_block_index_dims();
+    index<N> idx;
+    abs_index<N>::get_index(m_sch.get_abs_index(m_i), bidims, idx);
+    gen_bto_mult_direct_task<N, Traits, Timed> *t =
+        new gen_bto_mult_direct_task<N, Traits, Timed>(m_bto, m_btc, idx,
+            m_out);
+    ++m_i;
+    return t;
+}
+
+
+template<size_t N, typename Traits>
+void gen_bto_mult_direct_task_observer<N, Traits>::notify_finish_task(
+    libutil::task_i *t) {
+
+    delete t;
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_GEN_BTO_MULT_DIRECT_IMPL_H
@@ -111,13 +111,14 @@ typename Traits::element_type gen_bto_trace<N, Traits, Timed>::calculate() {
 
     std::vector<task_type *> tasklist;
 
-    orbit_list<NA, element_type> ola(ca.req_const_symmetry());
+    std::vector<size_t> nzblka;
+    ca.req_nonzero_blocks(nzblka);
+    orbit_list<NA, element_type> ola(ca.req_const_symmetry(), nzblka);
     for (typename orbit_list<NA, element_type>::iterator ioa = ola.begin();
             ioa != ola.end(); ioa++) {
 
         index<NA> idxa;
         ola.get_index(ioa, idxa);
-        if(ca.req_is_zero_block(idxa)) continue;
 
         task_type *t = new task_type(m_bta, m_perm, ola, idxa, bidimsa);
         tasklist.push_back(t);
@@ -15,13 +15,14 @@ void gen_bto_vmpriority<N, Traits>::set_priority() {
 
     gen_block_tensor_rd_ctrl<N, bti_traits> ctrl(m_bt);
 
-    orbit_list<N, element_type> ol(ctrl.req_const_symmetry());
+    std::vector<size_t> nzblk;
+    ctrl.req_nonzero_blocks(nzblk);
+    orbit_list<N, element_type> ol(ctrl.req_const_symmetry(), nzblk);
     for(typename orbit_list<N, element_type>::iterator io = ol.begin();
         io != ol.end(); ++io) {
 
         index<N> bi;
         ol.get_index(io, bi);
-        if(ctrl.req_is_zero_block(bi)) continue;
 
         rd_block_type &blk = ctrl.req_const_block(bi);
         to_vmpriority(blk).set_priority();
@@ -38,14 +39,15 @@ void gen_bto_vmpriority<N, Traits>::unset_priority() {
 
     gen_block_tensor_rd_ctrl<N, bti_traits> ctrl(m_bt);
 
-    orbit_list<N, element_type> ol(ctrl.req_const_symmetry());
+    std::vector<size_t> nzblk;
+    ctrl.req_nonzero_blocks(nzblk);
+    orbit_list<N, element_type> ol(ctrl.req_const_symmetry(), nzblk);
 
     for(typename orbit_list<N, element_type>::iterator io = ol.begin();
             io != ol.end(); ++io) {
 
         index<N> bi;
         ol.get_index(io, bi);
-        if(ctrl.req_is_zero_block(bi)) continue;
 
         rd_block_type &blk = ctrl.req_const_block(bi);
         to_vmpriority(blk).unset_priority();
@@ -0,0 +1,45 @@
+#ifndef LIBTENSOR_KERN_DDIVSUM2_H
+#define LIBTENSOR_KERN_DDIVSUM2_H
+
+#include <libtensor/linalg/linalg.h>
+#include "kernel_base.h"
+
+namespace libtensor {
+
+
+/** \brief Division by a sum kernel (double)
+
+    This kernel divides an array by the scaled sum of two other arrays:
+    \f[
+        c = c + d \frac{n}{k_a a + k_b b}
+    \f]
+    n, a, b, c are arrays, ka, kb, d are scaling factors.
+
+    \ingroup libtensor_kernels
+ **/
+class kern_ddivsum2 : public kernel_base<linalg, 3, 1> {
+public:
+    static const char *k_clazz; //!< Kernel name
+
+private:
+    double m_ka, m_kb;
+    double m_d;
+
+public:
+    virtual ~kern_ddivsum2() { }
+
+    virtual const char *get_name() const {
+        return k_clazz;
+    }
+
+    virtual void run(void*, const loop_registers<3, 1> &r);
+
+    static kernel_base<linalg, 3, 1> *match(double ka, double kb, double d,
+        list_t &in, list_t &out);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_KERN_DDIVSUM2_H
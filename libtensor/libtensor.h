@@ -41,6 +41,8 @@
 
 #include "expr/bispace/bispace.h"
 #include "expr/btensor/btensor.h"
+#include "expr/iface/expr_batch.h"
+#include "expr/iface/expr_plan.h"
 #include "expr/iface/expr_tensor.h"
 #include "expr/operators/operators.h"
 
@@ -47,6 +47,8 @@ public:
         double *c, size_t sic,
         double d);
 
+    static bool set_num_threads(size_t n);
+
 };
 
 
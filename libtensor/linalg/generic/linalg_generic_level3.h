@@ -125,6 +125,14 @@ public:
         double *c, size_t sic,
         double d);
 
+    /** \brief Sets the number of threads the BLAS library uses in calls from
+            the current thread
+        \param n Number of threads (zero to restore the default).
+        \return False if the number of threads cannot be controlled
+            (always the case for the generic implementation).
+     **/
+    static bool set_num_threads(size_t n);
+
 };
 
 
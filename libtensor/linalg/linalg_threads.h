@@ -0,0 +1,129 @@
+#ifndef LIBTENSOR_LINALG_THREADS_H
+#define LIBTENSOR_LINALG_THREADS_H
+
+#include <libutil/thread_pool/thread_pool.h>
+#include "linalg.h"
+
+namespace libtensor {
+
+
+/** \brief Lends idle CPUs of the thread pool to a multi-threaded BLAS call
+
+    Tasks in the thread pool normally call BLAS with one thread each. When
+    a task is about to run a large matrix multiplication while other
+    workers are idle (for example, when a few large blocks remain at the end
+    of a block tensor operation), this object borrows the free CPUs from
+    the pool (see libutil::thread_pool::acquire_cpus()) and lets the BLAS
+    library use them in the current thread. The destructor restores
+    the default number of BLAS threads and returns the CPUs to the pool.
+
+    The number of threads is limited by the amount of work: each thread
+    gets at least get_min_flops() floating-point operations. Small
+    multiplications and calls outside of a thread pool run as before.
+
+    Only backends that can change the number of threads at run time make
+    use of the borrowed CPUs, with the other backends the object does
+    nothing. MKL sets the number of threads for the calling thread only.
+    OpenBLAS has a single process-wide setting, so it is only used if
+    enabled at build time (WITH_OPENBLAS_THREADS), and then only one
+    multiplication at a time gets more than one thread. Other threads
+    calling OpenBLAS during that multiplication use its threads too.
+
+    \ingroup libtensor_linalg
+ **/
+class linalg_threads {
+private:
+    size_t m_nthreads; //!< Number of BLAS threads
+
+public:
+    /** \brief Borrows CPUs for a multiplication
+        \param flops Number of floating-point operations.
+     **/
+    explicit linalg_threads(double flops) : m_nthreads(1) {
+
+        size_t n = size_t(flops / get_min_flops());
+        if(max_threads() > 0 && n > max_threads()) n = max_threads();
+        if(n < 2) return;
+
+        size_t nb = libutil::thread_pool::acquire_cpus(n - 1);
+        if(nb == 0) return;
+        if(!linalg::set_num_threads(nb + 1)) {
+            libutil::thread_pool::release_cpus(nb);
+            return;
+        }
+        m_nthreads = nb + 1;
+    }
+
+    /** \brief Restores the default number of BLAS threads and returns
+            the CPUs
+     **/
+    ~linalg_threads() {
+
+        if(m_nthreads > 1) {
+            linalg::set_num_threads(0);
+            libutil::thread_pool::release_cpus(m_nthreads - 1);
+        }
+    }
+
+    /** \brief Returns the number of threads given to BLAS (including
+            the current thread)
+     **/
+    size_t get_nthreads() const {
+        return m_nthreads;
+    }
+
+    /** \brief Returns the name of the timer that records calls with
+            the chosen number of threads
+     **/
+    const char *get_timer_name() const {
+        static const char *names[] = {
+            "blas_1", "blas_2", "blas_3", "blas_4",
+            "blas_5", "blas_6", "blas_7", "blas_8",
+            "blas_9", "blas_10", "blas_11", "blas_12",
+            "blas_13", "blas_14", "blas_15", "blas_16"
+        };
+        return m_nthreads <= 16 ? names[m_nthreads - 1] : "blas_17+";
+    }
+
+    /** \brief Sets the minimum number of floating-point operations per
+            BLAS thread (default 5e7)
+     **/
+    static void set_min_flops(double flops) {
+        min_flops() = flops;
+    }
+
+    /** \brief Returns the minimum number of floating-point operations per
+            BLAS thread
+     **/
+    static double get_min_flops() {
+        return min_flops();
+    }
+
+    /** \brief Sets the maximum number of BLAS threads per call (zero for
+            no limit, one to disable borrowing)
+     **/
+    static void set_max_threads(size_t n) {
+        max_threads() = n;
+    }
+
+private:
+    static double &min_flops() {
+        static double flops = 5e7;
+        return flops;
+    }
+
+    static size_t &max_threads() {
+        static size_t n = 0;
+        return n;
+    }
+
+private:
+    linalg_threads(const linalg_threads&);
+    const linalg_threads &operator=(const linalg_threads&);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_LINALG_THREADS_H
@@ -54,6 +54,8 @@ public:
         double *c, size_t sic,
         double d);
 
+    static bool set_num_threads(size_t n);
+
 };
 
 
@@ -1,11 +1,18 @@
 #ifndef LIBTENSOR_SO_DIRPROD_IMPL_H
 #define LIBTENSOR_SO_DIRPROD_IMPL_H
 
+#include "../symmetry_operation_cache.h"
+
 namespace libtensor {
 
 template<size_t N, size_t M, typename T>
 void so_dirprod<N, M, T>::perform(symmetry<N + M, T> &sym3) {
 
+    symmetry_operation_cache &cache = symmetry_operation_cache::get_instance();
+    symmetry_operation_key key("so_dirprod");
+    key.add(m_sym1).add(m_sym2).add(m_perm);
+    if(cache.lookup(key, sym3)) return;
+
     sym3.clear();
 
     for(typename symmetry<N, T>::iterator i = m_sym1.begin();
@@ -57,6 +64,8 @@ void so_dirprod<N, M, T>::perform(symmetry<N + M, T> &sym3) {
 
         copy_subset(set3, sym3);
     }
+
+    cache.store(key, sym3);
 }
 
 
@@ -2,6 +2,7 @@
 #define LIBTENSOR_SO_MERGE_IMPL_H
 
 #include "../bad_symmetry.h"
+#include "../symmetry_operation_cache.h"
 
 namespace libtensor {
 
@@ -50,6 +51,11 @@ so_merge<N, M, T>::so_merge(const symmetry<N, T> &sym1,
 template<size_t N, size_t M, typename T>
 void so_merge<N, M, T>::perform(symmetry<N - M, T> &sym2) {
 
+    symmetry_operation_cache &cache = symmetry_operation_cache::get_instance();
+    symmetry_operation_key key("so_merge");
+    key.add(M).add(m_sym1).add(m_msk).add(m_mseq);
+    if(cache.lookup(key, sym2)) return;
+
     sym2.clear();
     for(typename symmetry<N, T>::iterator i = m_sym1.begin();
             i != m_sym1.end(); i++) {
@@ -67,6 +73,8 @@ void so_merge<N, M, T>::perform(symmetry<N - M, T> &sym2) {
             sym2.insert(set2.get_elem(j));
         }
     }
+
+    cache.store(key, sym2);
 }
 
 } // namespace libtensor
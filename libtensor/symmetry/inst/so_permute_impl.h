@@ -1,11 +1,18 @@
 #ifndef LIBTENSOR_SO_PERMUTE_IMPL_H
 #define LIBTENSOR_SO_PERMUTE_IMPL_H
 
+#include "../symmetry_operation_cache.h"
+
 namespace libtensor {
 
 template<size_t N, typename T>
 void so_permute<N, T>::perform(symmetry<N, T> &sym2) {
 
+    symmetry_operation_cache &cache = symmetry_operation_cache::get_instance();
+    symmetry_operation_key key("so_permute");
+    key.add(m_sym1).add(m_perm);
+    if(cache.lookup(key, sym2)) return;
+
     sym2.clear();
 
     for(typename symmetry<N, T>::iterator i = m_sym1.begin();
@@ -23,6 +30,8 @@ void so_permute<N, T>::perform(symmetry<N, T> &sym2) {
             sym2.insert(set2.get_elem(j));
         }
     }
+
+    cache.store(key, sym2);
 }
 
 } // namespace libtensor
@@ -2,6 +2,7 @@
 #define LIBTENSOR_SO_SYMMETRIZE_IMPL_H
 
 #include "../so_copy.h"
+#include "../symmetry_operation_cache.h"
 
 namespace libtensor {
 
@@ -97,6 +98,11 @@ void so_symmetrize<N, T>::perform(symmetry<N, T> &sym2) {
         return;
     }
 
+    symmetry_operation_cache &cache = symmetry_operation_cache::get_instance();
+    symmetry_operation_key key("so_symmetrize");
+    key.add(m_sym1).add(m_idxgrp).add(m_symidx).add(m_trp).add(m_trc);
+    if(cache.lookup(key, sym2)) return;
+
     sym2.clear();
 
     bool perm_done = false;
@@ -135,6 +141,8 @@ void so_symmetrize<N, T>::perform(symmetry<N, T> &sym2) {
             sym2.insert(set2.get_elem(j));
         }
     }
+
+    cache.store(key, sym2);
 }
 
 } // namespace libtensor
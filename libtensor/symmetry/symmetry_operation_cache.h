@@ -0,0 +1,302 @@
+#ifndef LIBTENSOR_SYMMETRY_OPERATION_CACHE_H
+#define LIBTENSOR_SYMMETRY_OPERATION_CACHE_H
+
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <libutil/singleton.h>
+#include <libutil/threads/auto_lock.h>
+#include <libutil/threads/mutex.h>
+#include "../core/mask.h"
+#include "../core/permutation.h"
+#include "../core/scalar_transf.h"
+#include "../core/sequence.h"
+#include "../core/symmetry.h"
+
+namespace libtensor {
+
+
+/** \brief Key of a %symmetry operation in the cache
+
+    The key identifies an operation by its name and the sequence of all its
+    parameters including the fingerprints of the argument %symmetry objects.
+    The parameters are added one by one in the order fixed by the operation.
+
+    \sa symmetry_operation_cache
+
+    \ingroup libtensor_symmetry
+ **/
+class symmetry_operation_key {
+private:
+    std::string m_key; //!< Binary key
+
+public:
+    /** \brief Initializes the key with the name of the operation
+     **/
+    symmetry_operation_key(const char *op) : m_key(op) {
+        m_key.push_back('\0');
+    }
+
+    /** \brief Adds an integer parameter
+     **/
+    symmetry_operation_key &add(size_t n) {
+        m_key.append((const char*)&n, sizeof(size_t));
+        return *this;
+    }
+
+    /** \brief Adds the fingerprint of a %symmetry
+     **/
+    template<size_t N, typename T>
+    symmetry_operation_key &add(const symmetry<N, T> &sym) {
+        return add(N).add(sym.get_fingerprint());
+    }
+
+    /** \brief Adds a permutation
+     **/
+    template<size_t N>
+    symmetry_operation_key &add(const permutation<N> &perm) {
+        for(size_t i = 0; i < N; i++) add(perm[i]);
+        return *this;
+    }
+
+    /** \brief Adds a mask
+     **/
+    template<size_t N>
+    symmetry_operation_key &add(const mask<N> &msk) {
+        size_t n = 0;
+        for(size_t i = 0; i < N; i++) {
+            if(i % 64 == 0 && i > 0) {
+                add(n);
+                n = 0;
+            }
+            if(msk[i]) n |= (size_t(1) << (i % 64));
+        }
+        return add(n);
+    }
+
+    /** \brief Adds a sequence
+     **/
+    template<size_t N>
+    symmetry_operation_key &add(const sequence<N, size_t> &seq) {
+        for(size_t i = 0; i < N; i++) add(seq[i]);
+        return *this;
+    }
+
+    /** \brief Adds a scalar transformation
+     **/
+    template<typename T>
+    symmetry_operation_key &add(const scalar_transf<T> &tr) {
+        T c = tr.get_coeff();
+        m_key.append((const char*)&c, sizeof(T));
+        return *this;
+    }
+
+    /** \brief Returns the binary key
+     **/
+    const std::string &get_key() const {
+        return m_key;
+    }
+
+};
+
+
+/** \brief Global LRU cache of the results of %symmetry operations
+
+    The results of %symmetry operations (so_permute, so_merge, so_dirprod,
+    so_symmetrize) are stored in the cache keyed by the fingerprints of
+    the argument %symmetry objects and the parameters of the operation
+    (see symmetry_operation_key). When the same operation is requested on
+    unchanged arguments, the result is copied from the cache instead of
+    being recomputed.
+
+    The result is assigned the fingerprint it had when it was first computed,
+    so subsequent operations on the result can be served from the cache too.
+
+    The cache keeps up to a given number of results and evicts the least
+    recently used ones. It can be emptied at any time. The cache also holds
+    references to product tables via se_label elements, therefore it is
+    emptied by product_table_container before a table is altered or removed.
+
+    The cache is thread-safe.
+
+    \ingroup libtensor_symmetry
+ **/
+class symmetry_operation_cache :
+    public libutil::singleton<symmetry_operation_cache> {
+
+    friend class libutil::singleton<symmetry_operation_cache>;
+
+public:
+    static const char *k_clazz; //!< Class name
+
+    //! Default maximum number of cached results
+    static const size_t k_default_max_size = 1024;
+
+private:
+    class result_i {
+    public:
+        virtual ~result_i() { }
+    };
+
+    template<size_t N, typename T>
+    class result : public result_i {
+    public:
+        symmetry<N, T> sym;
+        result(const block_index_space<N> &bis) : sym(bis) { }
+        virtual ~result() { }
+    };
+
+    struct entry {
+        result_i *res; //!< Cached result
+        std::list<std::string>::iterator lru; //!< Position in LRU list
+    };
+
+    typedef std::map<std::string, entry> map_t;
+
+private:
+    libutil::mutex m_lock; //!< Lock
+    map_t m_map; //!< Cached results
+    std::list<std::string> m_lru; //!< Keys, most recently used first
+    size_t m_max_size; //!< Max number of results
+    size_t m_nhits; //!< Number of hits
+    size_t m_nmisses; //!< Number of misses
+
+public:
+    /** \brief Destroys the cache
+     **/
+    virtual ~symmetry_operation_cache();
+
+    /** \brief Looks up the result of an operation
+        \param key Key of the operation.
+        \param[out] sym Result symmetry (only modified if found).
+        \return True if the result was found, false otherwise.
+     **/
+    template<size_t N, typename T>
+    bool lookup(const symmetry_operation_key &key, symmetry<N, T> &sym);
+
+    /** \brief Stores the result of an operation
+        \param key Key of the operation.
+        \param sym Result symmetry.
+     **/
+    template<size_t N, typename T>
+    void store(const symmetry_operation_key &key, const symmetry<N, T> &sym);
+
+    /** \brief Removes all results from the cache
+     **/
+    void clear();
+
+    /** \brief Sets the maximum number of cached results (0 disables
+            the cache)
+     **/
+    void set_max_size(size_t max_size);
+
+    /** \brief Returns the number of cached results
+     **/
+    size_t get_size();
+
+    /** \brief Returns the number of hits since the last reset
+     **/
+    size_t get_nhits();
+
+    /** \brief Returns the number of misses since the last reset
+     **/
+    size_t get_nmisses();
+
+    /** \brief Resets the hit and miss counters
+     **/
+    void reset_stats();
+
+protected:
+    symmetry_operation_cache();
+
+private:
+    /** \brief Removes the least recently used results until the cache has
+            no more than the given number of results (call with lock held)
+     **/
+    void evict(size_t max_size);
+
+    template<size_t N, typename T>
+    static void copy(const symmetry<N, T> &sym1, symmetry<N, T> &sym2);
+
+};
+
+
+template<size_t N, typename T>
+bool symmetry_operation_cache::lookup(const symmetry_operation_key &key,
+    symmetry<N, T> &sym) {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    map_t::iterator i = m_map.find(key.get_key());
+    if(i == m_map.end()) {
+        m_nmisses++;
+        return false;
+    }
+    result<N, T> *res = dynamic_cast< result<N, T>* >(i->second.res);
+    if(res == 0 || !res->sym.get_bis().equals(sym.get_bis())) {
+        m_nmisses++;
+        return false;
+    }
+
+    copy(res->sym, sym);
+    sym.m_fprint = res->sym.m_fprint;
+    m_lru.splice(m_lru.begin(), m_lru, i->second.lru);
+    m_nhits++;
+    return true;
+}
+
+
+template<size_t N, typename T>
+void symmetry_operation_cache::store(const symmetry_operation_key &key,
+    const symmetry<N, T> &sym) {
+
+    libutil::auto_lock<libutil::mutex> lock(m_lock);
+
+    if(m_max_size == 0) return;
+
+    map_t::iterator i = m_map.find(key.get_key());
+    if(i != m_map.end()) {
+        delete i->second.res;
+        m_lru.erase(i->second.lru);
+        m_map.erase(i);
+    }
+
+    evict(m_max_size - 1);
+
+    result<N, T> *res = new result<N, T>(sym.get_bis());
+    try {
+        copy(sym, res->sym);
+    } catch(...) {
+        delete res;
+        throw;
+    }
+    res->sym.m_fprint = sym.m_fprint;
+
+    entry e;
+    e.res = res;
+    e.lru = m_lru.insert(m_lru.begin(), key.get_key());
+    m_map.insert(std::make_pair(key.get_key(), e));
+}
+
+
+template<size_t N, typename T>
+void symmetry_operation_cache::copy(const symmetry<N, T> &sym1,
+    symmetry<N, T> &sym2) {
+
+    sym2.clear();
+    for(typename symmetry<N, T>::iterator i = sym1.begin();
+        i != sym1.end(); ++i) {
+
+        const symmetry_element_set<N, T> &set1 = sym1.get_subset(i);
+        for(typename symmetry_element_set<N, T>::const_iterator j =
+            set1.begin(); j != set1.end(); ++j) {
+            sym2.insert(set1.get_elem(j));
+        }
+    }
+}
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_SYMMETRY_OPERATION_CACHE_H
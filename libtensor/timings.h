@@ -1,7 +1,10 @@
 #ifndef LIBTENSOR_TIMINGS_H
 #define LIBTENSOR_TIMINGS_H
 
+#include <vector>
+#include <libutil/threads/tls.h>
 #include <libutil/timings/timings.h>
+#include "core/memory_accounting.h"
 
 namespace libtensor {
 
@@ -18,6 +21,9 @@ namespace libtensor {
      - add start_timer and stop_timer calls around the parts of the code that
        should be timed;
 
+    While the default timer runs, the class is also an owner for memory
+    accounting (see memory_accounting).
+
     \ingroup libtensor_core
  **/
 template<typename T> class timings;
@@ -31,16 +37,70 @@ struct libtensor_timings { };
 
 
 #ifdef LIBTENSOR_TIMINGS
-
-template<typename T>
-class timings : public libutil::timings<T, libtensor_timings, true> { };
-
+#define LIBTENSOR_TIMINGS_ENABLED true
 #else
+#define LIBTENSOR_TIMINGS_ENABLED false
+#endif // LIBTENSOR_TIMINGS
 
 template<typename T>
-class timings : public libutil::timings<T, libtensor_timings, false> { };
-
-#endif // LIBTENSOR_TIMINGS
+class timings :
+    public libutil::timings<T, libtensor_timings, LIBTENSOR_TIMINGS_ENABLED> {
+
+private:
+    typedef libutil::timings<T, libtensor_timings, LIBTENSOR_TIMINGS_ENABLED>
+        timings_base;
+
+    /** \brief Whether each running default timer of the class in the
+            current thread has entered an owner scope, innermost last
+     **/
+    struct owner_flags {
+        std::vector<bool> pushed;
+    };
+
+protected:
+    /** \brief Starts the default timer
+     **/
+    static void start_timer() {
+        bool push = memory_accounting::is_enabled();
+        if(push) memory_accounting::push_owner(T::k_clazz);
+        get_owner_flags().push_back(push);
+        timings_base::start_timer();
+    }
+
+    /** \brief Stops the default timer
+     **/
+    static void stop_timer() {
+        timings_base::stop_timer();
+        //  Accounting may have been turned on or off since the timer started
+        std::vector<bool> &pushed = get_owner_flags();
+        if(pushed.empty()) return;
+        bool push = pushed.back();
+        pushed.pop_back();
+        if(push) memory_accounting::pop_owner(T::k_clazz);
+    }
+
+    /** \brief Starts a custom timer
+        \param name Timer name.
+     **/
+    static void start_timer(const char *name) {
+        timings_base::start_timer(name);
+    }
+
+    /** \brief Stops a custom timer
+        \param name Timer name.
+     **/
+    static void stop_timer(const char *name) {
+        timings_base::stop_timer(name);
+    }
+
+private:
+    static std::vector<bool> &get_owner_flags() {
+        return libutil::tls<owner_flags>::get_instance().get().pushed;
+    }
+
+};
+
+#undef LIBTENSOR_TIMINGS_ENABLED
 
 
 } // namespace libtensor
@@ -0,0 +1,56 @@
+#ifndef LIBUTIL_CPU_SLOTS_H
+#define LIBUTIL_CPU_SLOTS_H
+
+#include <cstddef>
+#include <vector>
+#include "cpu_topology.h"
+
+namespace libutil {
+
+
+/** \brief Keeps track of the CPU slots taken by pinned workers
+
+    The slots are the CPUs of a cpu_topology enumerated node by node (see
+    cpu_topology::get_slot()). A worker takes a free slot when it starts
+    running and gives it back when it parks, so running workers never share
+    a CPU as long as there are enough slots. A returning worker gets its
+    previous slot back if it is still free, otherwise a free slot in the same
+    node, and only then a slot in another node.
+
+    The class is not thread-safe, the caller is responsible for locking.
+
+    \ingroup libutil_thread_pool
+ **/
+class cpu_slots {
+public:
+    static const size_t npos = size_t(-1); //!< No slot
+
+private:
+    const cpu_topology &m_topo; //!< Layout of CPUs
+    std::vector<bool> m_busy; //!< Whether each slot is taken
+
+public:
+    /** \brief Initializes the slots of a topology, all free
+     **/
+    cpu_slots(const cpu_topology &topo);
+
+    /** \brief Takes a free slot and returns it, or npos if all the slots
+            are taken
+        \param pref Preferred slot (npos if none).
+     **/
+    size_t acquire(size_t pref = npos);
+
+    /** \brief Makes a slot available again
+     **/
+    void release(size_t slot);
+
+    /** \brief Returns the number of free slots
+     **/
+    size_t get_nfree() const;
+
+};
+
+
+} // namespace libutil
+
+#endif // LIBUTIL_CPU_SLOTS_H
@@ -0,0 +1,81 @@
+#ifndef LIBUTIL_CPU_TOPOLOGY_H
+#define LIBUTIL_CPU_TOPOLOGY_H
+
+#include <cstddef>
+#include <vector>
+
+namespace libutil {
+
+
+/** \brief Layout of CPUs in NUMA domains
+
+    On Linux, the NUMA nodes and their CPUs are read from
+    /sys/devices/system/node. On other systems or if the information is not
+    available, all online CPUs are placed in a single node.
+
+    \ingroup libutil_thread_pool
+ **/
+class cpu_topology {
+private:
+    std::vector< std::vector<size_t> > m_nodes; //!< CPUs in each node
+
+public:
+    /** \brief Detects the topology of the current machine
+     **/
+    cpu_topology();
+
+    /** \brief Uses the given layout instead of detecting it
+        \param nodes CPUs in each node.
+     **/
+    cpu_topology(const std::vector< std::vector<size_t> > &nodes) :
+        m_nodes(nodes) { }
+
+    /** \brief Returns the number of NUMA nodes
+     **/
+    size_t get_nnodes() const {
+        return m_nodes.size();
+    }
+
+    /** \brief Returns the CPUs in a NUMA node
+     **/
+    const std::vector<size_t> &get_cpus(size_t node) const {
+        return m_nodes[node];
+    }
+
+    /** \brief Returns the total number of CPUs
+     **/
+    size_t get_ncpus() const;
+
+    /** \brief Returns the CPU and its node for a given sequential number
+            of a worker
+        \param n Sequential number of the worker.
+        \param[out] cpu CPU number.
+        \param[out] node NUMA node number.
+
+        The CPUs are enumerated node by node, so consecutive workers fill
+        one node before moving to the next.
+     **/
+    void get_slot(size_t n, size_t &cpu, size_t &node) const;
+
+    /** \brief Binds the current thread to a CPU, returns false if binding
+            is not supported or failed
+     **/
+    static bool pin_current_thread(size_t cpu);
+
+    /** \brief Writes to every page in a memory region, so the pages are
+            physically allocated on the node of the current thread under the
+            first-touch policy
+        \param p Start of the memory region.
+        \param sz Size of the region in bytes.
+     **/
+    static void first_touch(void *p, size_t sz);
+
+private:
+    void detect();
+
+};
+
+
+} // namespace libutil
+
+#endif // LIBUTIL_CPU_TOPOLOGY_H
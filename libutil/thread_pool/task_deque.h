@@ -0,0 +1,91 @@
+#ifndef LIBUTIL_TASK_DEQUE_H
+#define LIBUTIL_TASK_DEQUE_H
+
+#include <cstddef>
+#include "task_info.h"
+
+namespace libutil {
+
+
+/** \brief Lock-free work-stealing deque of tasks (Chase-Lev)
+
+    The deque is owned by one worker thread, which pushes and pops tasks at
+    the bottom end without locking. Other threads (thieves) may concurrently
+    take tasks from the top end. Conflicts over the last remaining task are
+    resolved with an atomic compare-and-swap on the top index.
+
+    The underlying circular buffer grows as needed. Replaced buffers are kept
+    until the deque is destroyed because a thief may still be reading from
+    them.
+
+    Synchronization relies on the GCC __sync builtins (also available in
+    Clang and the Intel compiler).
+
+    Reference:
+    D. Chase, Y. Lev, Dynamic circular work-stealing deque, SPAA 2005.
+
+    \ingroup libutil_thread_pool
+ **/
+class task_deque {
+private:
+    struct buffer {
+        long size; //!< Capacity (power of two)
+        task_info *data; //!< Circular array
+        buffer *prev; //!< Previous (smaller) buffer
+
+        buffer(long size_, buffer *prev_) :
+            size(size_), data(new task_info[size_]), prev(prev_) { }
+        ~buffer() { delete [] data; }
+    };
+
+private:
+    volatile long m_top; //!< Top index (thieves' end)
+    volatile long m_bottom; //!< Bottom index (owner's end)
+    buffer * volatile m_buf; //!< Current buffer
+
+public:
+    /** \brief Initializes an empty deque
+        \param size Initial capacity (rounded up to a power of two).
+     **/
+    task_deque(size_t size = 32);
+
+    /** \brief Destroys the deque
+     **/
+    ~task_deque();
+
+    /** \brief Pushes a task to the bottom of the deque (owner only)
+     **/
+    void push(const task_info &tinfo);
+
+    /** \brief Pops a task from the bottom of the deque (owner only)
+        \param[out] tinfo Task.
+        \return True if a task was returned, false if the deque is empty.
+     **/
+    bool pop(task_info &tinfo);
+
+    /** \brief Takes a task from the top of the deque (any thread)
+        \param[out] tinfo Task.
+        \return True if a task was stolen, false if the deque is empty or
+            the attempt lost the race with another thread.
+     **/
+    bool steal(task_info &tinfo);
+
+    /** \brief Returns true if the deque appears to be empty
+     **/
+    bool is_empty() const {
+        return m_bottom <= m_top;
+    }
+
+private:
+    buffer *grow(buffer *buf, long b, long t);
+
+private:
+    task_deque(const task_deque&);
+    const task_deque &operator=(const task_deque&);
+
+};
+
+
+} // namespace libutil
+
+#endif // LIBUTIL_TASK_DEQUE_H
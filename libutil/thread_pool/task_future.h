@@ -0,0 +1,98 @@
+#ifndef LIBUTIL_TASK_FUTURE_H
+#define LIBUTIL_TASK_FUTURE_H
+
+#include <libutil/exceptions/rethrowable_i.h>
+#include "task_iterator_i.h"
+#include "task_observer_i.h"
+
+namespace libutil {
+
+
+class task_source;
+class thread_pool;
+
+
+/** \brief Handle to tasks submitted to the thread pool asynchronously
+
+    A future is passed to thread_pool::submit_async(), which returns
+    immediately. The tasks are then run by the workers of the thread pool
+    while the submitting thread continues. wait() blocks until all the tasks
+    are completed and rethrows the first exception that occurred in any of
+    them, the same way thread_pool::submit() does.
+
+    If the future is destroyed while the tasks are still running, the
+    destructor waits for their completion and discards exceptions.
+
+    \sa thread_pool
+
+    \ingroup libutil_thread_pool
+ **/
+class task_future {
+    friend class thread_pool;
+
+private:
+    /** \brief Iterator over a single task owned by the future
+     **/
+    class single_task_iterator : public task_iterator_i {
+    private:
+        task_i *m_task; //!< Task (null when taken)
+
+    public:
+        single_task_iterator() : m_task(0) { }
+        void set_task(task_i *t) { m_task = t; }
+        virtual bool has_more() const { return m_task != 0; }
+        virtual task_i *get_next() {
+            task_i *t = m_task;
+            m_task = 0;
+            return t;
+        }
+    };
+
+    /** \brief Observer that ignores all notifications
+     **/
+    class null_observer : public task_observer_i {
+    public:
+        virtual void notify_start_task(task_i *t) { }
+        virtual void notify_finish_task(task_i *t) { }
+    };
+
+private:
+    thread_pool *m_pool; //!< Thread pool running the tasks
+    task_source *m_ts; //!< Source of pending tasks (null if none)
+    rethrowable_i *m_exc; //!< Exception from serial execution
+    task_i *m_task; //!< Owned task (null if none)
+    single_task_iterator m_ti; //!< Iterator over the owned task
+    null_observer m_to; //!< Observer of the owned task
+
+public:
+    /** \brief Initializes the future with no pending tasks
+     **/
+    task_future() : m_pool(0), m_ts(0), m_exc(0), m_task(0) { }
+
+    /** \brief Waits for the pending tasks to complete and destroys
+            the future
+     **/
+    ~task_future();
+
+    /** \brief Waits for the pending tasks to complete, rethrows exceptions
+            occurred in the tasks
+     **/
+    void wait();
+
+    /** \brief Returns true if the tasks have been submitted, but not yet
+            waited for
+     **/
+    bool is_pending() const {
+        return m_ts != 0 || m_exc != 0 || m_task != 0;
+    }
+
+private:
+    task_future(const task_future&);
+    const task_future &operator=(const task_future&);
+
+};
+
+
+} // namespace libutil
+
+#endif // LIBUTIL_TASK_FUTURE_H
@@ -23,6 +23,13 @@ namespace libutil {
     source from the root of the hierarchy using get_current() and then request
     tasks from that source using extract_task().
 
+    Tasks from children are handed out before the remaining tasks of their
+    parent. Among the children, the preferred source is picked according to
+    is_preferred(): higher priority first, then sources someone is waiting
+    on, then deeper sources (closer to the bottom of the critical path).
+    The priority is given when the source is created, zero means that it is
+    inherited from the parent.
+
     \ingroup libutil_thread_pool
  **/
 class task_source {
@@ -34,18 +41,35 @@ private:
     task_observer_i &m_to; //!< Task observer
     size_t m_npending; //!< Number of tasks about to be run
     size_t m_nrunning; //!< Number of currently running tasks
+    size_t m_nextracted; //!< Number of tasks extracted so far
+    unsigned long m_totcost; //!< Total cost of tasks extracted so far
+    int m_priority; //!< Priority
+    size_t m_depth; //!< Depth in the hierarchy
+    volatile bool m_waited; //!< Whether a thread waits for this source
     mutex m_mtx; //!< Mutex
     cond m_alldone; //!< All done signal
 
 public:
     /** \brief Initializes the task source
+        \param parent Parent task source (null for root).
+        \param ti Task iterator.
+        \param to Task observer.
+        \param priority Priority (zero to inherit from parent).
      **/
-    task_source(task_source *parent, task_iterator_i &ti, task_observer_i &to);
+    task_source(task_source *parent, task_iterator_i &ti, task_observer_i &to,
+        int priority = 0);
 
     /** \brief Destroys the task source
      **/
     ~task_source();
 
+    /** \brief Marks the source as waited on by a thread, which makes it
+            preferred over other sources of the same priority
+     **/
+    void set_waited() {
+        m_waited = true;
+    }
+
     /** \brief Waits for all the tasks from this source and its children
             to complete
      **/
@@ -61,10 +85,31 @@ public:
      **/
     task_source *get_current();
 
+    /** \brief Returns true if the source itself has tasks left
+            (not counting children)
+     **/
+    bool has_more();
+
+    /** \brief Returns the priority of the source
+     **/
+    int get_priority() const {
+        return m_priority;
+    }
+
+    /** \brief Returns true if tasks from source ts1 should be run before
+            tasks from source ts2
+     **/
+    static bool is_preferred(const task_source *ts1, const task_source *ts2);
+
     /** \brief Returns the next task from the source
      **/
     task_i *extract_task();
 
+    /** \brief Returns the average cost of the tasks extracted so far or
+            zero if fewer than nmin tasks have been extracted
+     **/
+    unsigned long get_average_cost(size_t nmin);
+
     /** \brief Notifies the task source that a task has been started
      **/
     void notify_start_task(task_i *t);
@@ -1,10 +1,9 @@
 #ifndef LIBUTIL_TASK_THIEF_H
 #define LIBUTIL_TASK_THIEF_H
 
-#include <deque>
-#include <map>
-#include <libutil/threads/mutex.h>
-#include <libutil/threads/spinlock.h>
+#include <vector>
+#include <libutil/threads/rwlock.h>
+#include "task_deque.h"
 #include "task_info.h"
 
 namespace libutil {
@@ -12,13 +11,25 @@ namespace libutil {
 
 /** \brief Steals tasks from workers' local queues
 
+    Each worker registers its local deque with the thief along with its NUMA
+    node. To steal a task, a victim is picked at random, and then the deques
+    are probed in order starting from that victim. Victims in the thief's own
+    node are probed first, then the rest. Stealing from a deque does not
+    require locking the deque, the list of victims is guarded by a read-write
+    lock that is only exclusively acquired to add or remove victims.
+
     \ingroup libutil_thread_pool
  **/
 class task_thief {
 private:
-    std::map< std::deque<task_info>*, spinlock* > m_queues; //!< Victims
-    std::map< std::deque<task_info>*, spinlock* >::iterator m_i;
-    spinlock m_mtx; //!< Lock
+    struct victim {
+        task_deque *lq; //!< Local queue
+        size_t node; //!< NUMA node
+    };
+
+private:
+    std::vector<victim> m_queues; //!< Victims
+    rwlock m_lock; //!< Lock on the list of victims
 
 public:
     /** \brief Initializes the task thief
@@ -27,15 +38,27 @@ public:
 
     /** \brief Adds a candidate victim for theft
      **/
-    void register_queue(std::deque<task_info> &lq, spinlock &lqmtx);
+    void register_queue(task_deque &lq, size_t node = 0);
 
     /** \brief Removes a queue from the list of candidates
      **/
-    void unregister_queue(std::deque<task_info> &lq);
+    void unregister_queue(task_deque &lq);
+
+    /** \brief Changes the NUMA node of a registered queue
+     **/
+    void set_node(task_deque &lq, size_t node);
 
     /** \brief Steals a task from one of the victims
+        \param[out] tinfo Stolen task (null if none found).
+        \param seed State of the thief's random number generator.
+        \param node NUMA node of the thief.
+     **/
+    void steal_task(task_info &tinfo, unsigned long &seed, size_t node = 0);
+
+    /** \brief Returns the next random number and updates the state
+            of the generator (xorshift)
      **/
-    void steal_task(task_info &tinfo);
+    static unsigned long next_random(unsigned long &seed);
 
 };
 
@@ -43,4 +66,3 @@ public:
 } // namespace libutil
 
 #endif // LIBUTIL_TASK_THIEF_H
-
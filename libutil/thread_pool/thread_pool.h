@@ -1,15 +1,19 @@
 #ifndef LIBUTIL_THREAD_POOL_H
 #define LIBUTIL_THREAD_POOL_H
 
-#include <deque>
 #include <map>
 #include <vector>
 #include <libutil/threads/mutex.h>
+#include <libutil/threads/rwlock.h>
 #include <libutil/threads/spinlock.h>
+#include "cpu_slots.h"
+#include "cpu_topology.h"
+#include "task_future.h"
 #include "task_iterator_i.h"
 #include "task_observer_i.h"
 #include "task_source.h"
 #include "task_thief.h"
+#include "thread_pool_trace.h"
 #include "worker.h"
 
 namespace libutil {
@@ -17,9 +21,32 @@ namespace libutil {
 
 /** \brief Thread pool
 
+    If requested, each worker is pinned to a free CPU whenever it starts
+    running and gives the CPU back when it goes idle or waits, so running
+    workers do not share CPUs (see cpu_slots). The CPUs are assigned in the
+    order of NUMA nodes (see cpu_topology), a worker returns to its previous
+    CPU or node if possible, and workers prefer to steal tasks from other
+    workers in the same node. Memory that is first touched by a pinned
+    worker is placed in its node, so allocators can use get_numa_node() to
+    keep the data near the threads that work on it.
+
+    Tasks can also be submitted without waiting for their completion, see
+    submit_async() and task_future.
+
+    The activity of the threads can be recorded for analysis, see
+    get_trace() and thread_pool_trace.
+
+    The pool lock only guards the lists of workers and the CPU accounting.
+    Workers look up and extract tasks from the hierarchy of task sources
+    under a read lock, so they do not wait for each other, and steal tasks
+    without any pool lock. Task sources are created and destroyed under the
+    write lock.
+
     \ingroup libutil_thread_pool
  **/
 class thread_pool {
+    friend class task_future;
+
 private:
     enum {
         WORKER_STATE_IDLE, WORKER_STATE_RUNNING
@@ -29,12 +56,9 @@ private:
         int state;
         cond sig;
         cond cpu;
-    };
-
-    struct ts_stats {
-        size_t ntasks;
-        unsigned long totcost;
-        ts_stats() : ntasks(0), totcost(0) { }
+        task_deque *lq; //!< Local queue
+        size_t slot; //!< CPU slot taken while running (or npos)
+        size_t pinned; //!< CPU slot the thread is pinned to (or npos)
     };
 
 private:
@@ -48,18 +72,25 @@ private:
     std::vector<worker*> m_running; //!< List of running threads
     std::vector<worker*> m_waiting; //!< List of waiting threads
     std::vector<worker*> m_waitingcpu; //!< List of threads waiting for CPU
-    task_source *m_tsroot; //!< Root task source
-    std::map<task_source*, ts_stats> m_tsstat; //!< Task source stats
+    std::vector<task_source*> m_tsroots; //!< Root task sources
+    volatile size_t m_tsgen; //!< Number of changes to the task sources
+        //!< (added, removed or waited on)
     task_thief m_thief; //!< Task thief
+    bool m_pin; //!< Whether workers are pinned to CPUs
+    cpu_topology m_topo; //!< Layout of CPUs in NUMA nodes
+    cpu_slots m_slots; //!< CPU slots taken by running workers
+    thread_pool_trace m_trace; //!< Trace of thread activity
     volatile bool m_term; //!< Termination flag
     spinlock m_mtx; //!< Mutex
+    rwlock m_tslock; //!< Lock on the hierarchy of task sources
 
 public:
     /** \brief Creates a thread pool
         \param nthreads Limit on non-idle (running + waiting) threads.
         \param ncpus Limit on number of CPUs (running threads).
+        \param pin Pin workers to CPUs grouped by NUMA node.
      **/
-    thread_pool(size_t nthreads, size_t ncpus);
+    thread_pool(size_t nthreads, size_t ncpus, bool pin = false);
 
     /** \brief Destroys the thread pool
      **/
@@ -79,6 +110,12 @@ public:
      **/
     void dissociate();
 
+    /** \brief Returns the trace of thread activity (disabled by default)
+     **/
+    thread_pool_trace &get_trace() {
+        return m_trace;
+    }
+
     /** \brief Worker's main function (task loop)
         \param w Worker.
      **/
@@ -87,8 +124,33 @@ public:
     /** \brief Submits a collection of tasks to the thread pool currently
             associated with the current thread. Returns when all the tasks
             have been completed
+        \param ti Task iterator.
+        \param to Task observer.
+        \param priority Priority hint, tasks with higher priority are run
+            first (zero to inherit the priority of the enclosing task).
      **/
-    static void submit(task_iterator_i &ti, task_observer_i &to);
+    static void submit(task_iterator_i &ti, task_observer_i &to,
+        int priority = 0);
+
+    /** \brief Submits a collection of tasks to the thread pool currently
+            associated with the current thread and returns immediately
+        \param ti Task iterator.
+        \param to Task observer.
+        \param f Future to wait on for the completion of the tasks.
+        \param priority Priority hint (see submit()).
+
+        The task iterator and observer must exist until f.wait() returns.
+        If the future is pending, it is waited on first. Without a thread
+        pool, the tasks are run right away and exceptions are deferred
+        until f.wait().
+     **/
+    static void submit_async(task_iterator_i &ti, task_observer_i &to,
+        task_future &f, int priority = 0);
+
+    /** \brief Submits one task asynchronously, the future takes ownership
+            of the task and deletes it once the task is completed
+     **/
+    static void submit_async(task_i *t, task_future &f, int priority = 0);
 
     /** \brief Allocates a CPU for the current thread (and waits for one
             to become available if necessary)
@@ -100,14 +162,85 @@ public:
      **/
     static void release_cpu();
 
+    /** \brief Lends free CPUs to the current thread without waiting, returns
+            the number of CPUs actually lent (at most n)
+        \param n Number of CPUs requested.
+
+        CPUs are free when they are not taken by running threads and no
+        thread is waiting for a CPU, i.e. the workers that would run on them
+        are idle. The current thread may use the borrowed CPUs for its own
+        threads (e.g. in a multi-threaded BLAS call) until it returns them
+        using release_cpus(). Without a thread pool, no CPUs are lent.
+     **/
+    static size_t acquire_cpus(size_t n);
+
+    /** \brief Returns CPUs borrowed using acquire_cpus()
+        \param n Number of CPUs.
+     **/
+    static void release_cpus(size_t n);
+
+    /** \brief Returns the NUMA node of the current thread if it is a pinned
+            worker, -1 otherwise
+     **/
+    static int get_numa_node();
+
 private:
     static void run_serial(task_iterator_i &ti, task_observer_i &to);
+    static void start_async(task_iterator_i &ti, task_observer_i &to,
+        task_future &f, int priority);
 
-    void do_submit(task_iterator_i &ti, task_observer_i &to);
+    void do_submit(task_iterator_i &ti, task_observer_i &to, int priority);
+    void do_submit_async(task_iterator_i &ti, task_observer_i &to,
+        task_future &f, int priority);
+    void wait_async(task_source *ts);
+    void wait_source(task_source &ts);
     void do_acquire_cpu(bool intask);
     void do_release_cpu(bool intask);
+    size_t do_acquire_cpus(size_t n);
+    void do_release_cpus(size_t n);
+
+    /** \brief Takes a free CPU slot for the current worker and pins the
+            thread to it
+     **/
+    void pin_worker(worker_info &wi);
+
+    /** \brief Gives the CPU slot of a worker back (the caller must hold
+            the pool lock)
+     **/
+    void release_slot(worker_info &wi);
+
+    void enqueue_local(task_deque &lq, size_t maxn, unsigned long &seed,
+        size_t node);
 
-    void enqueue_local(std::deque<task_info> &lq, size_t maxn, spinlock &lqmtx);
+    /** \brief Returns the start of a traced event
+     **/
+    thread_pool_trace::stamp trace_begin() const {
+        return m_trace.begin();
+    }
+
+    /** \brief Records an event that ends now in the trace of the current
+            thread if tracing was on when the event began
+     **/
+    void trace_end(int type, const thread_pool_trace::stamp &begin) {
+        if(begin.epoch != 0) record_trace(type, begin);
+    }
+
+    void record_trace(int type, const thread_pool_trace::stamp &begin);
+
+    task_source *new_source(task_source *parent, task_iterator_i &ti,
+        task_observer_i &to, int priority);
+    void delete_source(task_source *ts);
+
+    /** \brief Returns the preferred source with tasks left (the caller
+            must hold the lock on the hierarchy of task sources)
+
+        Each thread keeps the source it found last and only looks through
+        the hierarchy again once that source runs out of tasks or the
+        sources change.
+     **/
+    task_source *get_current_source();
+    bool has_current_source();
+    void remove_root(task_source *ts);
 
     void create_idle_thread();
     void activate_idle_thread();
@@ -16,8 +16,13 @@ struct thread_pool_info {
     thread_pool *pool; //!< Worker owner
     task_source *tsrc; //!< Current source of tasks
     worker *w; //!< Worker
+    int node; //!< NUMA node of pinned worker (-1 if not pinned)
+    thread_pool_trace::buffer *tbuf; //!< Trace buffer
+    task_source *cursrc; //!< Preferred source found last (or null)
+    size_t cursrcgen; //!< Generation of task sources when cursrc was found
 
-    thread_pool_info() : pool(0), tsrc(0), w(0) { }
+    thread_pool_info() : pool(0), tsrc(0), w(0), node(-1), tbuf(0),
+        cursrc(0), cursrcgen(0) { }
 
 };
 
@@ -0,0 +1,144 @@
+#ifndef LIBUTIL_THREAD_POOL_TRACE_H
+#define LIBUTIL_THREAD_POOL_TRACE_H
+
+#include <iostream>
+#include <vector>
+#include <libutil/threads/mutex.h>
+#include <libutil/threads/spinlock.h>
+#include <libutil/timings/timer.h>
+
+namespace libutil {
+
+
+/** \brief Records the activity of threads in a thread pool
+
+    When enabled, each thread of the pool records the periods of time it
+    spends running tasks, waiting idle for work, waiting for a CPU,
+    waiting for the completion of tasks it has submitted, and stealing tasks
+    from other workers. Each thread writes into its own buffer under a lock
+    that is only contended while the trace is started or read out. When
+    disabled, the cost is a check of a flag at each point of interest.
+
+    An interval is recorded if the trace was on when the interval began.
+    Intervals still in progress when the trace is stopped are recorded when
+    they end, cut off at the stop time. Intervals that began before the
+    trace was (re)started are dropped.
+
+    The trace is started and stopped from the main thread when no tasks are
+    running. After stopping, it can be written out in the Chrome trace event
+    format (to be viewed with chrome://tracing or Perfetto) or summarized as
+    a utilization report.
+
+    \sa thread_pool
+
+    \ingroup libutil_thread_pool
+ **/
+class thread_pool_trace {
+public:
+    enum {
+        EVENT_TASK, //!< Running a task
+        EVENT_IDLE, //!< Idle, no tasks available
+        EVENT_WAIT_CPU, //!< Waiting for a CPU
+        EVENT_WAIT_TASKS, //!< Waiting for submitted tasks to complete
+        EVENT_STEAL //!< Stealing a task from another worker
+    };
+
+    /** \brief Start of an interval
+     **/
+    struct stamp {
+        size_t epoch; //!< Number of the trace (zero if off)
+        double time; //!< Start time (s since start of trace)
+    };
+
+    struct event {
+        int type; //!< Type of event
+        double begin; //!< Start time (s since start of trace)
+        double end; //!< End time (s since start of trace)
+    };
+
+    struct buffer {
+        size_t id; //!< Thread number
+        bool worker; //!< Whether the thread is a worker
+        std::vector<event> events; //!< Recorded events
+        spinlock lock; //!< Lock on the events
+    };
+
+private:
+    volatile bool m_enabled; //!< Whether tracing is on
+    volatile size_t m_epoch; //!< Number of times tracing was started
+    time_pt_t m_t0; //!< Start of trace
+    double m_tstop; //!< Duration of trace
+    std::vector<buffer*> m_bufs; //!< Buffers of all threads
+    mutable mutex m_lock; //!< Lock on the buffers
+
+public:
+    /** \brief Initializes the trace (disabled)
+     **/
+    thread_pool_trace() : m_enabled(false), m_epoch(0), m_tstop(0.0) { }
+
+    /** \brief Destroys the trace
+     **/
+    ~thread_pool_trace();
+
+    /** \brief Discards previous events and starts recording
+     **/
+    void start();
+
+    /** \brief Stops recording
+     **/
+    void stop();
+
+    /** \brief Returns true if recording is on
+     **/
+    bool is_enabled() const {
+        return m_enabled;
+    }
+
+    /** \brief Returns the current time (s since the start of the trace)
+     **/
+    double now() const {
+        time_pt_t t;
+        t.now();
+        return time_diff_t(m_t0, t).wall_time();
+    }
+
+    /** \brief Creates a buffer for a new thread
+        \param worker Whether the thread is a worker.
+     **/
+    buffer *add_thread(bool worker);
+
+    /** \brief Returns the start of an interval that begins now
+     **/
+    stamp begin() const {
+        stamp s;
+        s.epoch = m_enabled ? m_epoch : 0;
+        s.time = s.epoch != 0 ? now() : 0.0;
+        return s;
+    }
+
+    /** \brief Records an interval that ends now (called by the owner of
+            the buffer)
+        \param buf Buffer.
+        \param type Type of event.
+        \param begin Start of the interval (see begin()).
+     **/
+    void record(buffer *buf, int type, const stamp &begin);
+
+    /** \brief Writes the trace in the Chrome trace event format (JSON)
+     **/
+    void write_chrome_trace(std::ostream &os) const;
+
+    /** \brief Prints the time each thread spent in each state
+     **/
+    void report(std::ostream &os) const;
+
+private:
+    thread_pool_trace(const thread_pool_trace&);
+    const thread_pool_trace &operator=(const thread_pool_trace&);
+
+};
+
+
+} // namespace libutil
+
+#endif // LIBUTIL_THREAD_POOL_TRACE_H
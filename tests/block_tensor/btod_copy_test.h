@@ -52,6 +52,8 @@ private:
 
     void test_bug_1() throw(libtest::test_exception);
 
+    void test_async_1() throw(libtest::test_exception);
+
 };
 
 
@@ -0,0 +1,24 @@
+#ifndef LIBTENSOR_BTOD_DIV_DIRSUM_TEST_H
+#define LIBTENSOR_BTOD_DIV_DIRSUM_TEST_H
+
+#include <libtest/unit_test.h>
+
+namespace libtensor {
+
+/** \brief Tests the libtensor::btod_div_dirsum class
+
+    \ingroup libtensor_tests_btod
+**/
+class btod_div_dirsum_test : public libtest::unit_test {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1(bool doadd) throw(libtest::test_exception);
+    void test_2(bool doadd) throw(libtest::test_exception);
+    void test_3() throw(libtest::test_exception);
+};
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_BTOD_DIV_DIRSUM_TEST_H
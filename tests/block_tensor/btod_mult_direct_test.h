@@ -0,0 +1,23 @@
+#ifndef LIBTENSOR_BTOD_MULT_DIRECT_TEST_H
+#define LIBTENSOR_BTOD_MULT_DIRECT_TEST_H
+
+#include <libtest/unit_test.h>
+
+namespace libtensor {
+
+/** \brief Tests the libtensor::btod_mult_direct class
+
+    \ingroup libtensor_tests_btod
+**/
+class btod_mult_direct_test : public libtest::unit_test {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1(bool recip, bool doadd) throw(libtest::test_exception);
+    void test_2(bool recip, bool doadd) throw(libtest::test_exception);
+};
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_BTOD_MULT_DIRECT_TEST_H
@@ -21,6 +21,7 @@ private:
     void test_op_4();
     void test_op_5();
     void test_op_6();
+    void test_op_7();
 
 };
 
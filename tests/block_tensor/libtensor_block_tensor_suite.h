@@ -19,12 +19,14 @@
 #include "btod_diag_test.h"
 #include "btod_diagonalize_test.h"
 #include "btod_dirsum_test.h"
+#include "btod_div_dirsum_test.h"
 #include "btod_dotprod_test.h"
 #include "btod_ewmult2_test.h"
 #include "btod_extract_test.h"
 #include "btod_import_raw_test.h"
 #include "btod_import_raw_stream_test.h"
 #include "btod_mult_test.h"
+#include "btod_mult_direct_test.h"
 #include "btod_mult1_test.h"
 #include "btod_print_test.h"
 #include "btod_random_test.h"
@@ -78,12 +80,14 @@ namespace libtensor {
     \li libtensor::btod_diag_test
     \li libtensor::btod_diagonalize_test
     \li libtensor::btod_dirsum_test
+    \li libtensor::btod_div_dirsum_test
     \li libtensor::btod_dotprod_test
     \li libtensor::btod_ewmult2_test
     \li libtensor::btod_extract_test
     \li libtensor::btod_import_raw_test
     \li libtensor::btod_import_raw_stream_test
     \li libtensor::btod_mult_test
+    \li libtensor::btod_mult_direct_test
     \li libtensor::btod_mult1_test
     \li libtensor::btod_print_test
     \li libtensor::btod_random_test
@@ -129,12 +133,14 @@ private:
     unit_test_factory<btod_diag_test> m_utf_btod_diag;
     unit_test_factory<btod_diagonalize_test> m_utf_btod_diagonalize;
     unit_test_factory<btod_dirsum_test> m_utf_btod_dirsum;
+    unit_test_factory<btod_div_dirsum_test> m_utf_btod_div_dirsum;
     unit_test_factory<btod_dotprod_test> m_utf_btod_dotprod;
     unit_test_factory<btod_ewmult2_test> m_utf_btod_ewmult2;
     unit_test_factory<btod_extract_test> m_utf_btod_extract;
     unit_test_factory<btod_import_raw_test> m_utf_btod_import_raw;
     unit_test_factory<btod_import_raw_stream_test> m_utf_btod_import_raw_stream;
     unit_test_factory<btod_mult_test> m_utf_btod_mult;
+    unit_test_factory<btod_mult_direct_test> m_utf_btod_mult_direct;
     unit_test_factory<btod_mult1_test> m_utf_btod_mult1;
     unit_test_factory<btod_print_test> m_utf_btod_print;
     unit_test_factory<btod_random_test> m_utf_btod_random;
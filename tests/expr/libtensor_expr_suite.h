@@ -14,6 +14,11 @@
 #include "node_set_test.h"
 #include "node_trace_test.h"
 #include "node_transform_test.h"
+#include "opt_contract_order_test.h"
+#include "opt_factor_contract_test.h"
+#include "opt_hoist_contract_scalar_test.h"
+#include "opt_merge_equiv_subexpr_test.h"
+#include "opt_trace_to_dot_product_test.h"
 
 using libtest::unit_test_factory;
 
@@ -41,6 +46,11 @@ namespace libtensor {
      - libtensor::node_set_test
      - libtensor::node_trace_test
      - libtensor::node_transform_test
+     - libtensor::opt_contract_order_test
+     - libtensor::opt_factor_contract_test
+     - libtensor::opt_hoist_contract_scalar_test
+     - libtensor::opt_merge_equiv_subexpr_test
+     - libtensor::opt_trace_to_dot_product_test
 
     \ingroup libtensor_tests_expr
  **/
@@ -58,6 +68,14 @@ private:
     unit_test_factory<node_set_test> m_utf_node_set;
     unit_test_factory<node_trace_test> m_utf_node_trace;
     unit_test_factory<node_transform_test> m_utf_node_transform;
+    unit_test_factory<opt_contract_order_test> m_utf_opt_contract_order;
+    unit_test_factory<opt_factor_contract_test> m_utf_opt_factor_contract;
+    unit_test_factory<opt_hoist_contract_scalar_test>
+        m_utf_opt_hoist_contract_scalar;
+    unit_test_factory<opt_merge_equiv_subexpr_test>
+        m_utf_opt_merge_equiv_subexpr;
+    unit_test_factory<opt_trace_to_dot_product_test>
+        m_utf_opt_trace_to_dot_product;
 
 public:
     //! Creates the suite
@@ -0,0 +1,27 @@
+#ifndef LIBTENSOR_OPT_FACTOR_CONTRACT_TEST_H
+#define LIBTENSOR_OPT_FACTOR_CONTRACT_TEST_H
+
+#include <libtest/unit_test.h>
+
+namespace libtensor {
+
+
+/** \brief Tests the libtensor::expr::opt_factor_contract optimizer
+
+    \ingroup libtensor_tests_expr
+**/
+class opt_factor_contract_test : public libtest::unit_test {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1() throw(libtest::test_exception);
+    void test_2() throw(libtest::test_exception);
+    void test_3() throw(libtest::test_exception);
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_OPT_FACTOR_CONTRACT_TEST_H
@@ -42,6 +42,9 @@ private:
 
     void test_contract3_ttt_1();
 
+    void test_factor_1();
+    void test_factor_2();
+
 };
 
 } // namespace libtensor
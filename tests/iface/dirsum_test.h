@@ -23,6 +23,8 @@ private:
     void test_te_1() throw(libtest::test_exception);
     void test_et_1() throw(libtest::test_exception);
     void test_ee_1() throw(libtest::test_exception);
+    void test_div_1() throw(libtest::test_exception);
+    void test_div_2() throw(libtest::test_exception);
 
 };
 
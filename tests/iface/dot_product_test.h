@@ -19,6 +19,7 @@ private:
     void test_te_ij_ij_1() throw(libtest::test_exception);
     void test_te_ij_ji_1() throw(libtest::test_exception);
     void test_et_1() throw(libtest::test_exception);
+    void test_te_2() throw(libtest::test_exception);
 
     void check_ref(const char *testname, double d, double d_ref)
         throw(libtest::test_exception);
@@ -19,6 +19,9 @@ private:
     void test_copy_2();
     void test_copy_3();
     void test_contract_1();
+    void test_concurrent_1();
+    void test_concurrent_2();
+    void test_interm_1();
 
 };
 
@@ -0,0 +1,26 @@
+#ifndef LIBTENSOR_EXPR_BATCH_TEST_H
+#define LIBTENSOR_EXPR_BATCH_TEST_H
+
+#include <libtest/unit_test.h>
+
+namespace libtensor {
+
+
+/** \brief Tests the libtensor::expr::expr_batch class
+
+    \ingroup libtensor_tests_iface
+**/
+class expr_batch_test : public libtest::unit_test {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1();
+    void test_2();
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_BATCH_TEST_H
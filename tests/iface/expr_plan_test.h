@@ -0,0 +1,27 @@
+#ifndef LIBTENSOR_EXPR_PLAN_TEST_H
+#define LIBTENSOR_EXPR_PLAN_TEST_H
+
+#include <libtest/unit_test.h>
+
+namespace libtensor {
+
+
+/** \brief Tests the libtensor::expr::expr_plan class
+
+    \ingroup libtensor_tests_iface
+**/
+class expr_plan_test : public libtest::unit_test {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1();
+    void test_2();
+    void test_3();
+
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_EXPR_PLAN_TEST_H
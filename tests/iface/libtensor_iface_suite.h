@@ -15,6 +15,8 @@
 #include "eval_register_test.h"
 #include "ewmult_test.h"
 #include "expr_test.h"
+#include "expr_batch_test.h"
+#include "expr_plan_test.h"
 #include "expr_tensor_test.h"
 #include "letter_expr_test.h"
 #include "letter_test.h"
@@ -49,6 +51,8 @@ namespace libtensor {
      - libtensor::eval_register_test
      - libtensor::ewmult_test
      - libtensor::expr_test
+     - libtensor::expr_batch_test
+     - libtensor::expr_plan_test
      - libtensor::expr_tensor_test
      - libtensor::letter_test
      - libtensor::letter_expr_test
@@ -74,6 +78,8 @@ private:
     unit_test_factory<eval_register_test> m_utf_eval_register;
     unit_test_factory<ewmult_test> m_utf_ewmult;
     unit_test_factory<expr_test> m_utf_expr;
+    unit_test_factory<expr_batch_test> m_utf_expr_batch;
+    unit_test_factory<expr_plan_test> m_utf_expr_plan;
     unit_test_factory<expr_tensor_test> m_utf_expr_tensor;
     unit_test_factory<letter_test> m_utf_letter;
     unit_test_factory<letter_expr_test> m_utf_letter_expr;
@@ -31,6 +31,7 @@ private:
     void test_ee_1a() throw(libtest::test_exception);
     void test_ee_1b() throw(libtest::test_exception);
     void test_ee_2() throw(libtest::test_exception);
+    void test_ee_3() throw(libtest::test_exception);
 
 };
 
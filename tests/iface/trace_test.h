@@ -20,6 +20,8 @@ private:
     void test_e_1();
     void test_e_2();
     void test_e_3();
+    void test_c_1();
+    void test_c_2();
 
     void check_ref(const char *testname, double d, double d_ref)
         throw(libtest::test_exception);
@@ -46,6 +46,7 @@
 #include "so_symmetrize_se_part_test.h"
 #include "so_symmetrize_test.h"
 #include "symmetry_element_set_adapter_test.h"
+#include "symmetry_operation_cache_test.h"
 
 using libtest::unit_test_factory;
 
@@ -104,6 +105,7 @@ namespace libtensor {
     \li libtensor::so_symmetrize_se_label_test
     \li libtensor::so_symmetrize_test
     \li libtensor::symmetry_element_set_adapter_test
+    \li libtensor::symmetry_operation_cache_test
 
  **/
 class libtensor_symmetry_suite : public libtest::test_suite {
@@ -154,6 +156,8 @@ private:
     unit_test_factory<so_symmetrize_test> m_utf_so_symmetrize;
     unit_test_factory<symmetry_element_set_adapter_test>
         m_utf_symmetry_element_set_adapter;
+    unit_test_factory<symmetry_operation_cache_test>
+        m_utf_symmetry_operation_cache;
 
 public:
     //!    Creates the suite
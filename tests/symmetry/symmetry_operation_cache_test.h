@@ -0,0 +1,30 @@
+#ifndef LIBTENSOR_SYMMETRY_OPERATION_CACHE_TEST_H
+#define LIBTENSOR_SYMMETRY_OPERATION_CACHE_TEST_H
+
+#include "se_label_test_base.h"
+
+namespace libtensor {
+
+
+/** \brief Tests the class libtensor::symmetry_operation_cache
+
+    \ingroup libtensor_tests_sym
+ **/
+class symmetry_operation_cache_test : public se_label_test_base {
+public:
+    virtual void perform() throw(libtest::test_exception);
+
+private:
+    void test_1() throw(libtest::test_exception);
+    void test_2() throw(libtest::test_exception);
+    void test_3() throw(libtest::test_exception);
+    void test_4(const std::string &table_id) throw(libtest::test_exception);
+
+    using se_label_test_base::setup_pg_table;
+    using se_label_test_base::clear_pg_table;
+};
+
+
+} // namespace libtensor
+
+#endif // LIBTENSOR_SYMMETRY_OPERATION_CACHE_TEST_H